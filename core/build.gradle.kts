@@ -101,6 +101,11 @@ kotlin {
         }
     }
 
+    /* The implementation of the timezone database on Linux: "date" (the default) uses the `date` library,
+     * "chrono" uses `std::chrono::tzdb` from the C++ standard library. */
+    val linuxTzBackend = (project.findProperty("kotlinx.datetime.native.linuxTzBackend") as String?) ?: "date"
+    require(linuxTzBackend in listOf("date", "chrono")) { "Unknown timezone backend for Linux: $linuxTzBackend" }
+
     targets.withType<org.jetbrains.kotlin.gradle.plugin.mpp.KotlinNativeTarget> {
         compilations["test"].kotlinOptions {
             freeCompilerArgs += listOf("-trw")
@@ -117,6 +122,15 @@ kotlin {
                 extraOpts("-Xsource-compiler-option", "-I$cinteropDir/public")
                 extraOpts("-Xsource-compiler-option", "-DONLY_C_LOCALE=1")
                 when {
+                    konanTarget.family == org.jetbrains.kotlin.konan.target.Family.LINUX && linuxTzBackend == "chrono" -> {
+                        /* the C++20 timezone support of the standard library; requires a GCC root with
+                         * libstdc++ 14 or newer, which is not what Kotlin/Native ships by default. */
+                        extraOpts("-Xsource-compiler-option", "-std=c++20")
+                        // the date library headers, needed for some pure calculations.
+                        extraOpts("-Xsource-compiler-option", "-I$dateLibDir/include")
+                        // the main source for the platform bindings.
+                        extraOpts("-Xcompile-source", "$cinteropDir/cpp/chrono_tzdb.cpp")
+                    }
                     konanTarget.family == org.jetbrains.kotlin.konan.target.Family.LINUX -> {
                         // needed for the date library so that it does not try to download the timezone database
                         extraOpts("-Xsource-compiler-option", "-DUSE_OS_TZDB=1")
@@ -141,11 +155,25 @@ kotlin {
                         throw IllegalArgumentException("Unknown native target ${this@withType}")
                     }
                 }
+                // the platform-independent sources built on top of the platform bindings.
+                for (source in listOf(
+                    "zone_table.cpp", "recurrence.cpp", "timer_wheel.cpp", "offset_index.cpp",
+                    "zone_classes.cpp", "tzif.cpp", "tzdb_versions.cpp",
+                    "tzdb_diff.cpp", "leap_seconds.cpp", "abbreviations.cpp",
+                    "numa.cpp", "zone_arena.cpp", "zone_names.cpp", "business_calendar.cpp",
+                    "calendar_columns.cpp", "local_time_until.cpp",
+                    "local_classification.cpp", "coarse_clock.cpp"
+                )) {
+                    extraOpts("-Xcompile-source", "$cinteropDir/cpp/$source")
+                }
             }
         }
         compilations["main"].defaultSourceSet {
             kotlin.srcDir("native/cinterop_actuals")
         }
+        compilations["test"].defaultSourceSet {
+            kotlin.srcDir("native/cinterop_test")
+        }
     }
 
 
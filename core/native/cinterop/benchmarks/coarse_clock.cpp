@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Measures reading the coarse clock, which is updated by a ticker thread
+   every millisecond, compared with reading the system clock each time, and
+   checks how far behind the system clock the coarse one gets.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       coarse_clock.cpp ../cpp/cdate.cpp ../cpp/coarse_clock.cpp \
+       ../cpp/zone_table.cpp ../cpp/zone_arena.cpp ../cpp/numa.cpp \
+       ../cpp/abbreviations.cpp ../../../../thirdparty/date/src/tz.cpp \
+       -lpthread -o coarse_clock */
+#include <chrono>
+#include <cstdio>
+extern "C" {
+#include "cdate.h"
+}
+
+int main()
+{
+    const int reads = 100000000;
+    const int32_t tick_microseconds = 1000;
+    if (!coarse_clock_start(tick_microseconds)) {
+        printf("Unable to start the coarse clock\n");
+        return 1;
+    }
+    int64_t checksum = 0, max_lag = 0;
+    auto before = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; ++i) {
+        checksum += coarse_clock_epoch_nanos();
+    }
+    double coarse = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - before).count();
+    before = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads / 10; ++i) {
+        int64_t sec;
+        int32_t nano;
+        current_time(&sec, &nano);
+        checksum += nano;
+    }
+    double system = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - before).count();
+    for (int i = 0; i < reads / 10; ++i) {
+        int64_t coarse_nanos = coarse_clock_epoch_nanos();
+        int64_t sec;
+        int32_t nano;
+        current_time(&sec, &nano);
+        int64_t lag = sec * 1000000000 + nano - coarse_nanos;
+        max_lag = lag > max_lag ? lag : max_lag;
+    }
+    coarse_clock_stop();
+    bool stopped = coarse_clock_epoch_nanos() == INT64_MIN;
+    printf("%.2f ns per coarse read, %.2f ns per system clock read, "
+        "the coarse clock is up to %.3f ms behind (checksum %lld)\n",
+        coarse * 1e9 / reads, system * 1e9 / (reads / 10), max_lag / 1e6,
+        (long long)checksum);
+    return stopped ? 0 : 1;
+}
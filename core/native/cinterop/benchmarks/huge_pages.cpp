@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Measures the lookups of offsets in random zones with the zone tables
+   spread over the heap and with them packed into huge pages. The tables are
+   built in a random order, with unrelated allocations in between, as would
+   happen in a long-running service, and then 20 million lookups are made at
+   random instants in random zones.
+
+   The tables can't be moved once built, so each mode needs its own run:
+     ./huge_pages         # the tables on the heap
+     ./huge_pages arena   # the tables in huge pages
+   The checksums printed by both runs should be the same.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       huge_pages.cpp ../cpp/cdate.cpp ../cpp/zone_table.cpp \
+       ../cpp/zone_arena.cpp ../cpp/numa.cpp ../cpp/abbreviations.cpp \
+       ../../../../thirdparty/date/src/tz.cpp -lpthread -o huge_pages */
+#include "zone_table.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const size_t count = 20000000;
+    bool arena = argc > 1 && strcmp(argv[1], "arena") == 0;
+    if (arena) {
+        printf("huge pages: %s\n",
+            zone_tables_use_huge_pages(true) ? "yes" : "no");
+    }
+    std::mt19937_64 random(42);
+    auto zones = all_zone_ids();
+    std::shuffle(zones.begin(), zones.end(), random);
+    std::vector<std::unique_ptr<char[]>> noise;
+    std::vector<const zone_table *> tables;
+    for (auto zone : zones) {
+        auto table = compiled_zone(zone);
+        if (table != nullptr) {
+            tables.push_back(table);
+        }
+        for (int i = 0; i < 4; ++i) {
+            noise.emplace_back(new char[1024 + random() % 8192]);
+        }
+    }
+    std::vector<uint32_t> queried(count);
+    std::vector<int64_t> instants(count);
+    for (size_t i = 0; i < count; ++i) {
+        queried[i] = (uint32_t)(random() % tables.size());
+        // 1900-2100
+        instants[i] = -2208988800LL + (int64_t)(random() % 6311433600LL);
+    }
+    int64_t checksum = 0;
+    auto before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        zone_period period;
+        tables[queried[i]]->period_at(instants[i], period);
+        checksum += period.offset;
+    }
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - before).count();
+    printf("%s: %zu zones, %.1f ns per lookup, checksum %lld\n",
+        arena ? "arena" : "heap", tables.size(), elapsed * 1e9 / count,
+        (long long)checksum);
+    return 0;
+}
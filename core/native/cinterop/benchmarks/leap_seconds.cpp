@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Measures the throughput of the conversions between UTC and TAI for arrays
+   of 10 million instants, both spread over 1970-2030 and recent ones, which
+   are after the last leap second.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       leap_seconds.cpp ../cpp/cdate.cpp ../cpp/zone_table.cpp \
+       ../cpp/tzif.cpp ../cpp/leap_seconds.cpp ../cpp/abbreviations.cpp \
+       ../cpp/numa.cpp ../cpp/zone_arena.cpp \
+       ../../../../thirdparty/date/src/tz.cpp -lpthread -o leap_seconds */
+extern "C" {
+#include "cdate.h"
+}
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static void measure(const char *name, const std::vector<int64_t>& utc)
+{
+    std::vector<int64_t> tai(utc.size()), back(utc.size());
+    auto before = std::chrono::steady_clock::now();
+    if (!utc_to_tai(utc.data(), tai.data(), utc.size())) {
+        printf("no table of leap seconds is available\n");
+        return;
+    }
+    double forward = seconds_since(before);
+    before = std::chrono::steady_clock::now();
+    tai_to_utc(tai.data(), back.data(), tai.size());
+    double backward = seconds_since(before);
+    printf("%s: UTC->TAI %.2f ns, TAI->UTC %.2f ns per instant%s\n", name,
+        forward * 1e9 / utc.size(), backward * 1e9 / utc.size(),
+        back == utc ? "" : " (round trip failed)");
+}
+
+int main()
+{
+    const size_t count = 10000000;
+    std::mt19937_64 random(42);
+    std::vector<int64_t> instants(count);
+    // warm up: the table is loaded on first use.
+    utc_to_tai(instants.data(), instants.data(), 0);
+    for (auto& instant : instants) {
+        instant = (int64_t)(random() % 1893456000); // 1970-2030
+    }
+    measure("1970-2030", instants);
+    for (auto& instant : instants) {
+        instant = 1600000000 + (int64_t)(random() % 200000000);
+    }
+    measure("recent", instants);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Measures the mapping of local date-times to UTC with the local intervals
+   of the zone tables, which takes a single search, compared with looking
+   through the periods around each date-time. Local date-times at random
+   moments of 1900-2100 and around every transition of that time in all the
+   zones are resolved both ways, and the results are checked to agree.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       local_resolution.cpp ../cpp/cdate.cpp ../cpp/zone_table.cpp \
+       ../cpp/zone_arena.cpp ../cpp/numa.cpp ../cpp/abbreviations.cpp \
+       ../../../../thirdparty/date/src/tz.cpp -lpthread -o local_resolution */
+#include "zone_table.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/* The mapping of local date-times to UTC without the local intervals: all
+   the periods that can contain the date-time are checked in order. */
+static bool resolve_by_periods(const zone_table& table, int64_t local_sec,
+    local_resolution& result)
+{
+    const int64_t window = 24 * 60 * 60;
+    zone_period period, previous;
+    int found = 0;
+    bool has_previous = false;
+    if (!table.period_at(local_sec - window, period)) {
+        return false;
+    }
+    while (true) {
+        int64_t instant = local_sec - period.offset;
+        if (instant >= period.begin && instant < period.end) {
+            (found == 0 ? result.first : result.second) = period;
+            ++found;
+        } else if (found == 0 && has_previous && instant < period.begin) {
+            result.kind = LOCAL_GAP;
+            result.first = previous;
+            result.second = period;
+            return true;
+        }
+        if (period.end >= local_sec + window || found == 2) {
+            break;
+        }
+        previous = period;
+        has_previous = true;
+        if (!table.period_at(period.end, period)) {
+            return false;
+        }
+    }
+    result.kind = found == 1 ? LOCAL_UNIQUE : LOCAL_OVERLAP;
+    return found > 0;
+}
+
+static bool same(const local_resolution& a, const local_resolution& b)
+{
+    if (a.kind != b.kind || a.first.begin != b.first.begin ||
+        a.first.offset != b.first.offset)
+    {
+        return false;
+    }
+    return a.kind == LOCAL_UNIQUE || (a.second.begin == b.second.begin &&
+        a.second.offset == b.second.offset);
+}
+
+int main()
+{
+    std::mt19937_64 random(42);
+    std::vector<const zone_table *> tables;
+    std::vector<size_t> queried;
+    std::vector<int64_t> locals;
+    for (auto zone : all_zone_ids()) {
+        auto table = compiled_zone(zone);
+        if (table == nullptr) {
+            continue;
+        }
+        for (size_t i = 1; i < table->period_count(); ++i) {
+            auto period = table->period(i);
+            if (period.begin < -2208988800LL || period.begin > 4102444800LL) {
+                continue;
+            }
+            for (int64_t delta = -7200; delta <= 7200; delta += 900) {
+                queried.push_back(tables.size());
+                locals.push_back(period.begin + period.offset + delta);
+            }
+        }
+        tables.push_back(table);
+    }
+    for (size_t i = 0; i < 10000000; ++i) {
+        queried.push_back(random() % tables.size());
+        // 1900-2100
+        locals.push_back(-2208988800LL + (int64_t)(random() % 6311433600LL));
+    }
+    int64_t checksums[2] = {0, 0};
+    auto before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < locals.size(); ++i) {
+        local_resolution result;
+        tables[queried[i]]->resolve_local(locals[i], result);
+        checksums[0] += result.first.offset + result.kind;
+    }
+    double by_intervals = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - before).count();
+    before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < locals.size(); ++i) {
+        local_resolution result;
+        resolve_by_periods(*tables[queried[i]], locals[i], result);
+        checksums[1] += result.first.offset + result.kind;
+    }
+    double by_periods = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - before).count();
+    size_t mismatches = checksums[0] == checksums[1] ? 0 : 1;
+    for (size_t i = 0; i < locals.size(); ++i) {
+        local_resolution indexed, scanned;
+        tables[queried[i]]->resolve_local(locals[i], indexed);
+        resolve_by_periods(*tables[queried[i]], locals[i], scanned);
+        if (!same(indexed, scanned)) {
+            ++mismatches;
+        }
+    }
+    printf("%zu zones, %zu date-times: %.1f ns with the local intervals, "
+        "%.1f ns through the periods, %zu mismatches\n", tables.size(),
+        locals.size(), by_intervals * 1e9 / locals.size(),
+        by_periods * 1e9 / locals.size(), mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
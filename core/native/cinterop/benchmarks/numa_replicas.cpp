@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Compares the lookups in the zone tables from the memory of another NUMA
+   node with the lookups in the tables replicated to the local node. The
+   tables of all the zones are built on node 0, and then the threads pinned to
+   each node look up the offsets at 10 million random instants in random
+   zones, first in the tables of node 0 and then with replication enabled.
+   On a machine with a single node, only the first measurement is made.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       numa_replicas.cpp ../cpp/cdate.cpp ../cpp/zone_table.cpp \
+       ../cpp/numa.cpp ../cpp/abbreviations.cpp ../cpp/zone_arena.cpp \
+       ../../../../thirdparty/date/src/tz.cpp -lpthread -o numa_replicas */
+#include "numa.hpp"
+#include "zone_table.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+static void pin_to_node(size_t node)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : numa_node_cpus(node)) {
+        CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static double lookups_per_second(size_t node, const std::vector<TZID>& zones,
+    const std::vector<TZID>& queried, const std::vector<int64_t>& instants)
+{
+    double result = 0;
+    std::thread thread([&]() {
+        pin_to_node(node);
+        // Make sure that the replicas, if any, are built before measuring.
+        for (auto zone : zones) {
+            compiled_zone(zone);
+        }
+        int64_t checksum = 0;
+        auto before = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < instants.size(); ++i) {
+            zone_period period;
+            auto table = compiled_zone(queried[i]);
+            table->period_at(instants[i], period);
+            checksum += period.offset;
+        }
+        double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - before).count();
+        result = instants.size() / elapsed;
+        if (checksum == 1) {
+            printf("unlikely\n");
+        }
+    });
+    thread.join();
+    return result;
+}
+
+int main()
+{
+    const size_t count = 10000000;
+    size_t nodes = numa_node_count();
+    pin_to_node(0);
+    std::vector<TZID> zones;
+    for (auto zone : all_zone_ids()) {
+        if (compiled_zone(zone) != nullptr) {
+            zones.push_back(zone);
+        }
+    }
+    std::mt19937_64 random(42);
+    std::vector<TZID> queried(count);
+    std::vector<int64_t> instants(count);
+    for (size_t i = 0; i < count; ++i) {
+        queried[i] = zones[random() % zones.size()];
+        // 1900-2100
+        instants[i] = -2208988800LL + (int64_t)(random() % 6311433600LL);
+    }
+    printf("%zu nodes, %zu zones\n", nodes, zones.size());
+    for (size_t node = 0; node < nodes; ++node) {
+        if (numa_node_cpus(node).empty()) {
+            continue;
+        }
+        zone_tables_replicate_per_node(false);
+        double shared = lookups_per_second(node, zones, queried, instants);
+        printf("node %zu, tables on node 0: %.1f M lookups/s\n", node,
+            shared / 1e6);
+        if (zone_tables_replicate_per_node(true)) {
+            double local = lookups_per_second(node, zones, queried, instants);
+            printf("node %zu, replicated tables: %.1f M lookups/s\n", node,
+                local / 1e6);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Compares the Linux implementations of `cdate.h`: the one based on the
+   `date` library (`cdate.cpp`) and the one based on `std::chrono::tzdb`
+   (`chrono_tzdb.cpp`). The same program is built against each of them, and
+   it measures the loading of the timezone database, the lookup of zones by
+   name, and the conversions between instants and local date-times for
+   1 million random queries spread over all the zones and 1900-2100.
+
+   Build on Linux from this directory with
+     g++ -std=c++11 -O2 -DUSE_OS_TZDB=1 -DONLY_C_LOCALE=1 \
+       -I../public -I../../../../thirdparty/date/include \
+       tz_backends.cpp ../cpp/cdate.cpp ../cpp/abbreviations.cpp \
+       ../cpp/zone_table.cpp ../cpp/zone_arena.cpp ../cpp/numa.cpp \
+       ../../../../thirdparty/date/src/tz.cpp -lpthread -o tz_backends_date
+   and, with libstdc++ 14 or newer,
+     g++ -std=c++20 -O2 -I../public \
+       tz_backends.cpp ../cpp/chrono_tzdb.cpp ../cpp/abbreviations.cpp \
+       ../cpp/zone_table.cpp ../cpp/zone_arena.cpp ../cpp/numa.cpp \
+       -lpthread -o tz_backends_chrono
+   then run both. */
+extern "C" {
+#include "cdate.h"
+}
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const size_t count = 1000000;
+    auto before = std::chrono::steady_clock::now();
+    char **names = available_zone_ids();
+    if (names == nullptr) {
+        printf("the timezone database is not available\n");
+        return 1;
+    }
+    printf("loading the database: %.2f ms\n", seconds_since(before) * 1e3);
+    std::vector<std::string> zone_names;
+    for (char **name = names; *name != nullptr; ++name) {
+        zone_names.push_back(*name);
+        free(*name);
+    }
+    free(names);
+
+    std::vector<TZID> zones;
+    before = std::chrono::steady_clock::now();
+    for (auto& name : zone_names) {
+        zones.push_back(timezone_by_name(name.c_str()));
+    }
+    printf("%zu zones, by name: %.2f us per zone\n", zones.size(),
+        seconds_since(before) * 1e6 / zones.size());
+
+    std::mt19937_64 random(42);
+    std::vector<TZID> query_zones(count);
+    std::vector<int64_t> instants(count);
+    for (size_t i = 0; i < count; ++i) {
+        query_zones[i] = zones[random() % zones.size()];
+        // 1900-2100
+        instants[i] = -2208988800LL + (int64_t)(random() % 6311433600LL);
+    }
+
+    int64_t checksum = 0;
+    before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        checksum += offset_at_instant(query_zones[i], instants[i]);
+    }
+    printf("offset_at_instant: %.1f ns per call\n",
+        seconds_since(before) * 1e9 / count);
+
+    before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        int offset = INT_MAX;
+        checksum += offset_at_datetime(query_zones[i], instants[i], &offset);
+        checksum += offset;
+    }
+    printf("offset_at_datetime: %.1f ns per call\n",
+        seconds_since(before) * 1e9 / count);
+
+    before = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        int64_t midnight = instants[i] - (instants[i] % 86400 + 86400) % 86400;
+        checksum += at_start_of_day(query_zones[i], midnight);
+    }
+    printf("at_start_of_day: %.1f ns per call\n",
+        seconds_since(before) * 1e9 / count);
+
+    // Printed so that the results can be checked to agree between backends.
+    printf("checksum: %lld\n", (long long)checksum);
+    return 0;
+}
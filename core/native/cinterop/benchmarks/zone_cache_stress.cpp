@@ -0,0 +1,99 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* Stresses the concurrent initialization of the cached zone tables: many
+   threads start at once and request the tables of all the zones in different
+   orders, so that most of the tables are built by several threads
+   simultaneously. Checks that every thread sees the same table for each zone
+   and that the tables give the same offsets as the platform.
+
+   It is meant to be run under the thread sanitizer. Build on Linux from this
+   directory with
+     g++ -std=c++11 -O1 -g -fsanitize=thread -DUSE_OS_TZDB=1 \
+       -DONLY_C_LOCALE=1 -I../public -I../../../../thirdparty/date/include \
+       zone_cache_stress.cpp ../cpp/cdate.cpp ../cpp/zone_table.cpp \
+       ../cpp/abbreviations.cpp ../cpp/numa.cpp ../cpp/zone_arena.cpp \
+       ../../../../thirdparty/date/src/tz.cpp \
+       -lpthread -o zone_cache_stress */
+#include "zone_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    const size_t thread_count = 16;
+    const size_t rounds = 3;
+    auto zones = all_zone_ids();
+    if (zones.empty()) {
+        printf("the timezone database is not available\n");
+        return 1;
+    }
+    std::vector<std::vector<const zone_table *>> seen(thread_count,
+        std::vector<const zone_table *>(zones.size()));
+    std::atomic<size_t> ready(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937_64 random(t);
+            std::vector<size_t> order(zones.size());
+            for (size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            // Half of the threads go in the same order to collide more.
+            if (t % 2 == 1) {
+                std::shuffle(order.begin(), order.end(), random);
+            }
+            ++ready;
+            while (ready.load() < thread_count) {
+            }
+            for (size_t round = 0; round < rounds; ++round) {
+                for (size_t i : order) {
+                    auto table = compiled_zone(zones[i]);
+                    if (round > 0 && table != seen[t][i]) {
+                        table = nullptr;
+                    }
+                    seen[t][i] = table;
+                    zone_period period;
+                    if (table != nullptr) {
+                        table->period_at(1600000000, period);
+                    }
+                    abbreviation_at_instant(zones[i], 1600000000);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    size_t failures = 0;
+    for (size_t i = 0; i < zones.size(); ++i) {
+        for (size_t t = 0; t < thread_count; ++t) {
+            if (seen[t][i] == nullptr || seen[t][i] != seen[0][i]) {
+                ++failures;
+                break;
+            }
+        }
+        if (seen[0][i] == nullptr) {
+            continue;
+        }
+        for (int64_t instant = -2208988800LL; instant < compiled_until;
+            instant += 86400 * 97)
+        {
+            zone_period period;
+            if (!seen[0][i]->period_at(instant, period) ||
+                period.offset != offset_at_instant(zones[i], instant))
+            {
+                ++failures;
+                break;
+            }
+        }
+    }
+    printf("%zu zones, %zu threads: %zu failures\n", zones.size(),
+        thread_count, failures);
+    return failures == 0 ? 0 : 1;
+}
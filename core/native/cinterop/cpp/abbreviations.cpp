@@ -0,0 +1,186 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the queries about the abbreviations of zones, like
+   `CEST`, declared in `cdate.h`.
+
+   The abbreviations are interned, so they are returned without allocating
+   and compared as pointers. Like the offsets in `zone_table`, the
+   abbreviations of each zone are collected once until `compiled_until`; the
+   reverse index from the abbreviations to the zones is built from them on
+   first use. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include "published_tables.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// Guards `interned`.
+static std::mutex interned_mutex;
+// The elements of unordered sets don't move when more are added.
+static std::unordered_set<std::string> interned;
+
+const char *intern_abbreviation(const std::string& abbreviation)
+{
+    const std::lock_guard<std::mutex> lock(interned_mutex);
+    return interned.insert(abbreviation).first->c_str();
+}
+
+// Returns NULL if the abbreviation was never interned.
+static const char *find_interned(const char *abbreviation)
+{
+    const std::lock_guard<std::mutex> lock(interned_mutex);
+    auto it = interned.find(abbreviation);
+    return it == interned.end() ? nullptr : it->c_str();
+}
+
+namespace {
+
+/* The abbreviation is `names[i]` starting from `begins[i]`, until the next
+   one or, for the last one, `tail_end`, after which the platform is asked. */
+class abbreviation_table {
+public:
+    bool load(TZID zone) {
+        id = zone;
+        zone_period period;
+        const char *name;
+        if (!zone_abbreviation_at(zone, INT64_MIN, period, name)) {
+            return false;
+        }
+        period.begin = INT64_MIN;
+        while (true) {
+            if (names.empty() || names.back() != name) {
+                begins.push_back(period.begin);
+                names.push_back(name);
+            }
+            tail_end = period.end;
+            if (period.end >= compiled_until || period.end <= period.begin) {
+                break;
+            }
+            if (!zone_abbreviation_at(zone, period.end, period, name)) {
+                return false;
+            }
+        }
+        begins.shrink_to_fit();
+        names.shrink_to_fit();
+        return true;
+    }
+
+    const char *at(int64_t epoch_sec) const {
+        if (epoch_sec >= tail_end) {
+            zone_period period;
+            const char *name;
+            return zone_abbreviation_at(id, epoch_sec, period, name) ?
+                name : nullptr;
+        }
+        size_t i = std::upper_bound(begins.begin(), begins.end(), epoch_sec)
+            - begins.begin() - 1;
+        return names[i];
+    }
+
+    size_t size() const { return begins.size(); }
+    int64_t begin(size_t i) const { return begins[i]; }
+    int64_t end(size_t i) const {
+        return i + 1 < begins.size() ? begins[i + 1] : tail_end;
+    }
+    const char *name(size_t i) const { return names[i]; }
+
+private:
+    TZID id;
+    std::vector<int64_t> begins;
+    std::vector<const char *> names;
+    int64_t tail_end;
+};
+
+// The ranges [begin; end) when a zone used an abbreviation, sorted.
+struct abbreviation_uses {
+    TZID zone;
+    std::vector<int64_t> begins;
+    std::vector<int64_t> ends;
+};
+
+}
+
+static published_tables<abbreviation_table> tables;
+
+static const abbreviation_table *compiled_abbreviations(TZID zone)
+{
+    return tables.get(zone, [zone](abbreviation_table& table) {
+        return table.load(zone);
+    });
+}
+
+typedef std::unordered_map<const char *, std::vector<abbreviation_uses>>
+    abbreviation_index;
+
+static abbreviation_index build_index()
+{
+    abbreviation_index index;
+    for (auto id : all_zone_ids()) {
+        auto table = compiled_abbreviations(id);
+        if (table == nullptr) {
+            continue;
+        }
+        for (size_t i = 0; i < table->size(); ++i) {
+            auto& zones = index[table->name(i)];
+            // The zones are visited one after another.
+            if (zones.empty() || zones.back().zone != id) {
+                abbreviation_uses uses;
+                uses.zone = id;
+                zones.push_back(uses);
+            }
+            zones.back().begins.push_back(table->begin(i));
+            zones.back().ends.push_back(table->end(i));
+        }
+    }
+    return index;
+}
+
+static const abbreviation_index& index_of_abbreviations()
+{
+    // Initialization of local statics is thread-safe.
+    static const abbreviation_index index = build_index();
+    return index;
+}
+
+extern "C" {
+
+const char * abbreviation_at_instant(TZID zone, int64_t epoch_sec)
+{
+    auto table = compiled_abbreviations(zone);
+    return table == nullptr ? nullptr : table->at(epoch_sec);
+}
+
+TZID * zones_with_abbreviation(const char *abbreviation,
+    int64_t from_epoch_sec, int64_t until_epoch_sec, size_t *count)
+{
+    auto& index = index_of_abbreviations();
+    std::vector<TZID> result;
+    auto name = find_interned(abbreviation);
+    auto it = name == nullptr ? index.end() : index.find(name);
+    if (it != index.end()) {
+        for (auto& uses : it->second) {
+            // The first use that ends after `from`, if it begins before `until`.
+            size_t i = std::upper_bound(uses.ends.begin(), uses.ends.end(),
+                from_epoch_sec) - uses.ends.begin();
+            if (i < uses.begins.size() && uses.begins[i] < until_epoch_sec &&
+                from_epoch_sec < until_epoch_sec)
+            {
+                result.push_back(uses.zone);
+            }
+        }
+    }
+    TZID *array = check_allocation(
+        (TZID *)malloc(sizeof(TZID) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(TZID) * result.size());
+    }
+    *count = result.size();
+    return array;
+}
+
+}
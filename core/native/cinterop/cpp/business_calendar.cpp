@@ -0,0 +1,305 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the calendars of working days declared in `cdate.h`.
+
+   The days are split into blocks of 64, starting from 1970-01-01, and each
+   block is a word whose bits tell which of its days are working days. Most
+   days follow the weekly pattern, so only the blocks containing exceptions
+   to it are stored, sorted, however far apart they are; the words for the
+   others are taken from the seven possible patterns of a block.
+
+   Every query is expressed through the number of working days between the
+   epoch and a given day. For the weekly pattern, it is computed arithmetically,
+   and for the stored blocks, the difference from the pattern is kept as
+   prefix sums, so counting takes a binary search over the stored blocks.
+   Finding the day with a given number is a binary search over all the blocks
+   followed by picking the bit in the block. */
+extern "C" {
+#include "cdate.h"
+}
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+static int popcount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word != 0; word &= word - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : (a + 1) / b - 1;
+}
+
+static int64_t floor_mod(int64_t a, int64_t b)
+{
+    return a - floor_div(a, b) * b;
+}
+
+// The words with the bits before `bit` set.
+static uint64_t bits_below(int64_t bit)
+{
+    return bit >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bit) - 1;
+}
+
+/* The position of the set bit of `word` that has `rank` set bits below it,
+   which must be less than the number of the set bits. */
+static int select_bit(uint64_t word, int rank)
+{
+    int position = 0;
+    for (int width = 32; width > 0; width /= 2) {
+        uint64_t low = word & bits_below(width);
+        int count = popcount(low);
+        if (rank >= count) {
+            rank -= count;
+            word >>= width;
+            position += width;
+        } else {
+            word = low;
+        }
+    }
+    return position;
+}
+
+struct business_calendar {
+    // Bit 0 is Monday, ..., bit 6 is Sunday.
+    int weekdays;
+    int working_per_week;
+    /* `patterns[r]` is the word of a block whose first day is `r` days after
+       a Thursday, like 1970-01-01. */
+    uint64_t patterns[7];
+    /* `in_week[k]` is the number of working days among the first `k` days
+       starting from a Thursday. */
+    int in_week[8];
+    // The sorted numbers of the stored blocks and their words.
+    std::vector<int64_t> blocks;
+    std::vector<uint64_t> words;
+    /* `deltas[i]` is the number of working days in the stored blocks before
+       `blocks[i]` minus that number according to the pattern. */
+    std::vector<int64_t> deltas;
+
+    uint64_t pattern(int64_t block) const {
+        return patterns[floor_mod(block * 64, 7)];
+    }
+
+    // The index of the first stored block not before `block`.
+    size_t stored_index(int64_t block) const {
+        return std::lower_bound(blocks.begin(), blocks.end(), block) -
+            blocks.begin();
+    }
+
+    uint64_t word(int64_t block) const {
+        size_t i = stored_index(block);
+        if (i < blocks.size() && blocks[i] == block) {
+            return words[i];
+        }
+        return pattern(block);
+    }
+
+    /* The number of working days in [1970-01-01; day), or minus the number of
+       those in [day; 1970-01-01). */
+    int64_t working_before(int64_t day) const {
+        int64_t weeks = floor_div(day, 7);
+        int64_t result = weeks * working_per_week + in_week[day - weeks * 7];
+        if (blocks.empty()) {
+            return result;
+        }
+        int64_t block = floor_div(day, 64);
+        size_t i = stored_index(block);
+        result += deltas[i];
+        if (i == blocks.size() || blocks[i] != block) {
+            return result;
+        }
+        uint64_t mask = bits_below(day - block * 64);
+        return result +
+            popcount(words[i] & mask) - popcount(pattern(block) & mask);
+    }
+
+    void fill_patterns() {
+        working_per_week = popcount(weekdays);
+        for (int r = 0; r < 7; ++r) {
+            uint64_t word = 0;
+            for (int bit = 0; bit < 64; ++bit) {
+                // 1970-01-01 was a Thursday, day 3 counting from Monday.
+                if (weekdays & (1 << ((r + bit + 3) % 7))) {
+                    word |= (uint64_t)1 << bit;
+                }
+            }
+            patterns[r] = word;
+        }
+        in_week[0] = 0;
+        for (int k = 0; k < 7; ++k) {
+            in_week[k + 1] = in_week[k] + ((weekdays >> ((k + 3) % 7)) & 1);
+        }
+    }
+
+    /* Makes the stored blocks include the given ones, which must be sorted,
+       in a single merge, so that storing many blocks doesn't shift the
+       stored ones for each of them. */
+    void store_blocks(const std::vector<int64_t>& added) {
+        std::vector<int64_t> merged_blocks;
+        std::vector<uint64_t> merged_words;
+        merged_blocks.reserve(blocks.size() + added.size());
+        merged_words.reserve(blocks.size() + added.size());
+        size_t i = 0;
+        for (int64_t block : added) {
+            for (; i < blocks.size() && blocks[i] < block; ++i) {
+                merged_blocks.push_back(blocks[i]);
+                merged_words.push_back(words[i]);
+            }
+            if (i < blocks.size() && blocks[i] == block) {
+                continue;
+            }
+            merged_blocks.push_back(block);
+            merged_words.push_back(pattern(block));
+        }
+        merged_blocks.insert(merged_blocks.end(), blocks.begin() + i,
+            blocks.end());
+        merged_words.insert(merged_words.end(), words.begin() + i,
+            words.end());
+        blocks.swap(merged_blocks);
+        words.swap(merged_words);
+    }
+
+    void update_deltas() {
+        deltas.assign(words.size() + 1, 0);
+        for (size_t i = 0; i < words.size(); ++i) {
+            deltas[i + 1] = deltas[i] + popcount(words[i]) -
+                popcount(pattern(blocks[i]));
+        }
+    }
+
+    /* The working day that has `index` working days between the epoch and
+       it, or INT64_MAX if there's no such day. The search starts from
+       `near_day`, so it's faster when the result is close to it. */
+    int64_t working_day(int64_t index, int64_t near_day) const {
+        if (working_per_week == 0) {
+            // All the working days are in the stored blocks.
+            if (blocks.empty() || index < 0 || index >= deltas.back()) {
+                return INT64_MAX;
+            }
+        }
+        // Find the blocks `low` and `high` such that the day is in [low; high).
+        int64_t low = floor_div(near_day, 64), high = low + 1;
+        int64_t step = 1;
+        if (working_before(low * 64) <= index) {
+            while (working_before(high * 64) <= index) {
+                low = high;
+                high += step;
+                step *= 2;
+            }
+        } else {
+            high = low;
+            low -= step;
+            while (working_before(low * 64) > index) {
+                high = low;
+                step *= 2;
+                low -= step;
+            }
+        }
+        while (high - low > 1) {
+            int64_t middle = low + (high - low) / 2;
+            if (working_before(middle * 64) <= index) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        return low * 64 +
+            select_bit(word(low), (int)(index - working_before(low * 64)));
+    }
+};
+
+static int32_t to_epoch_day(int64_t day)
+{
+    return day < INT32_MIN || day > INT32_MAX ? INT32_MAX : (int32_t)day;
+}
+
+extern "C" {
+
+struct business_calendar * business_calendar_create(int working_weekdays)
+{
+    auto calendar = new business_calendar();
+    calendar->weekdays = working_weekdays & 0x7f;
+    calendar->fill_patterns();
+    return calendar;
+}
+
+void business_calendar_destroy(struct business_calendar *calendar)
+{
+    delete calendar;
+}
+
+void business_calendar_set_days(struct business_calendar *calendar,
+    const int32_t *epoch_days, size_t count, bool working)
+{
+    std::vector<int64_t> blocks(count);
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i] = floor_div(epoch_days[i], 64);
+    }
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    calendar->store_blocks(blocks);
+    for (size_t i = 0; i < count; ++i) {
+        int64_t block = floor_div(epoch_days[i], 64);
+        uint64_t bit = (uint64_t)1 << (epoch_days[i] - block * 64);
+        auto& word = calendar->words[calendar->stored_index(block)];
+        word = working ? word | bit : word & ~bit;
+    }
+    calendar->update_deltas();
+}
+
+bool business_calendar_is_working_day(const struct business_calendar *calendar,
+    int32_t epoch_day)
+{
+    int64_t block = floor_div(epoch_day, 64);
+    return (calendar->word(block) >> (epoch_day - block * 64)) & 1;
+}
+
+int32_t business_calendar_next_working_day(
+    const struct business_calendar *calendar, int32_t epoch_day)
+{
+    return to_epoch_day(
+        calendar->working_day(calendar->working_before(epoch_day), epoch_day));
+}
+
+void business_calendar_add_working_days(
+    const struct business_calendar *calendar, const int32_t *epoch_days,
+    const int32_t *working_days, int32_t *results, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        int64_t day = epoch_days[i];
+        int64_t n = working_days[i];
+        int64_t result = day;
+        if (n > 0) {
+            result = calendar->working_day(
+                calendar->working_before(day + 1) + n - 1, day + 1);
+        } else if (n < 0) {
+            result = calendar->working_day(
+                calendar->working_before(day) + n, day - 1);
+        }
+        results[i] = to_epoch_day(result);
+    }
+}
+
+void business_calendar_count_working_days(
+    const struct business_calendar *calendar, const int32_t *from_epoch_days,
+    const int32_t *until_epoch_days, int32_t *results, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = (int32_t)(calendar->working_before(until_epoch_days[i]) -
+            calendar->working_before(from_epoch_days[i]));
+    }
+}
+
+}
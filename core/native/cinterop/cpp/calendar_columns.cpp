@@ -0,0 +1,269 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the calendar dimension tables declared in `cdate.h`.
+
+   The days are visited in order, so the fields of each date are obtained from
+   those of the previous one, and the start of each day in a zone is found by
+   moving through the periods of the zone's table along with the days instead
+   of searching the table for each of them. */
+#include "zone_table.hpp"
+#include <climits>
+
+static const int64_t seconds_per_day = 24 * 60 * 60;
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : (a + 1) / b - 1;
+}
+
+static bool is_leap_year(int64_t year)
+{
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+static int month_length(int64_t year, int month)
+{
+    static const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && is_leap_year(year) ? 29 : lengths[month - 1];
+}
+
+// The fields of a date, which can be moved to the next day.
+struct calendar_date {
+    int64_t year;
+    int month;
+    int day;
+    // From 1 for Monday to 7 for Sunday.
+    int day_of_week;
+    int day_of_year;
+    int64_t week_based_year;
+    int week;
+    int weeks_in_week_based_year;
+
+    explicit calendar_date(int64_t epoch_day) {
+        // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+        int64_t shifted = epoch_day + 719468;
+        int64_t era = floor_div(shifted, 146097);
+        int64_t day_of_era = shifted - era * 146097;
+        int64_t year_of_era = (day_of_era - day_of_era / 1460 +
+            day_of_era / 36524 - day_of_era / 146096) / 365;
+        // Counting from March 1.
+        int64_t march_day = day_of_era -
+            (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        int64_t march_month = (5 * march_day + 2) / 153;
+        day = (int)(march_day - (153 * march_month + 2) / 5 + 1);
+        month = (int)(march_month < 10 ? march_month + 3 : march_month - 9);
+        year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+        day_of_year = march_day >= 306 ? (int)(march_day - 306 + 1) :
+            (int)(march_day + (is_leap_year(year) ? 60 : 59) + 1);
+        // 1970-01-01 was a Thursday.
+        day_of_week = (int)(epoch_day - floor_div(epoch_day + 3, 7) * 7 + 3) + 1;
+        /* The week-based year is the year of the Thursday of the week, and
+           the first week is the one with the first Thursday of the year. */
+        int thursday = day_of_year - day_of_week + 4;
+        week_based_year = year;
+        if (thursday < 1) {
+            --week_based_year;
+            thursday += is_leap_year(week_based_year) ? 366 : 365;
+        } else if (thursday > (is_leap_year(year) ? 366 : 365)) {
+            thursday -= is_leap_year(year) ? 366 : 365;
+            ++week_based_year;
+        }
+        week = (thursday - 1) / 7 + 1;
+        weeks_in_week_based_year = weeks_in(week_based_year);
+    }
+
+    void next() {
+        ++day_of_year;
+        if (++day > month_length(year, month)) {
+            day = 1;
+            if (++month > 12) {
+                month = 1;
+                ++year;
+                day_of_year = 1;
+            }
+        }
+        if (++day_of_week > 7) {
+            day_of_week = 1;
+            if (++week > weeks_in_week_based_year) {
+                week = 1;
+                ++week_based_year;
+                weeks_in_week_based_year = weeks_in(week_based_year);
+            }
+        }
+    }
+
+    /* A year has 53 weeks if it starts on a Thursday, or, for leap years, on
+       a Wednesday. */
+    static int weeks_in(int64_t year) {
+        // The day of the week of January 1, from 0 for Monday.
+        int64_t previous = year - 1;
+        int64_t days = previous * 365 + floor_div(previous, 4) -
+            floor_div(previous, 100) + floor_div(previous, 400);
+        int january1 = (int)(days - floor_div(days, 7) * 7);
+        return january1 == 3 || (january1 == 2 && is_leap_year(year)) ? 53 : 52;
+    }
+};
+
+static int64_t local_end(const zone_period& period)
+{
+    return period.end > INT64_MAX - seconds_per_day ? INT64_MAX :
+        period.end + period.offset;
+}
+
+// The index of the period of the table containing the instant.
+static size_t period_index(const zone_table& table, int64_t epoch_sec)
+{
+    size_t low = 0, high = table.period_count();
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (table.period(middle).begin <= epoch_sec) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/* The smaller of the offsets at the beginnings of January 1 and July 1 of
+   the year in UTC, taken as the standard offset of the zone in that year. */
+static bool standard_offset(const zone_table& table, int64_t year,
+    int& offset)
+{
+    int64_t previous = year - 1;
+    int64_t january1 = previous * 365 + floor_div(previous, 4) -
+        floor_div(previous, 100) + floor_div(previous, 400) - 719162;
+    int64_t july1 = january1 + 181 + (is_leap_year(year) ? 1 : 0);
+    zone_period winter, summer;
+    if (!table.period_at(january1 * seconds_per_day, winter) ||
+        !table.period_at(july1 * seconds_per_day, summer))
+    {
+        return false;
+    }
+    offset = winter.offset < summer.offset ? winter.offset : summer.offset;
+    return true;
+}
+
+static bool fill_zone(const zone_table& table, int64_t from_epoch_day,
+    size_t day_count, int64_t *starts_of_day, bool *daylight_saving)
+{
+    /* A period that begins before the start of the first day in any offset,
+       so that moving forward from it doesn't miss anything. */
+    size_t i = period_index(table,
+        from_epoch_day * seconds_per_day - 2 * seconds_per_day);
+    zone_period period = table.period(i);
+    calendar_date date(from_epoch_day);
+    int standard = 0;
+    if (daylight_saving != nullptr &&
+        !standard_offset(table, date.year, standard))
+    {
+        return false;
+    }
+    for (size_t row = 0; row < day_count; ++row) {
+        int64_t midnight = (from_epoch_day + (int64_t)row) * seconds_per_day;
+        while (midnight >= local_end(period) &&
+            i + 1 < table.period_count())
+        {
+            period = table.period(++i);
+        }
+        int64_t start;
+        int offset;
+        if (midnight < local_end(period)) {
+            /* If midnight happens twice, this is the earlier one, and if it
+               is skipped, the day starts at the end of the gap. */
+            start = midnight - period.offset >= period.begin ?
+                midnight - period.offset : period.begin;
+            offset = period.offset;
+        } else {
+            // Beyond the stored periods.
+            local_resolution resolution;
+            if (!table.resolve_local(midnight, resolution)) {
+                return false;
+            }
+            if (resolution.kind == LOCAL_GAP) {
+                start = resolution.second.begin;
+                offset = resolution.second.offset;
+            } else {
+                start = midnight - resolution.first.offset;
+                offset = resolution.first.offset;
+            }
+        }
+        if (starts_of_day != nullptr) {
+            starts_of_day[row] = start;
+        }
+        if (daylight_saving != nullptr) {
+            if (date.month == 1 && date.day == 1 && row > 0 &&
+                !standard_offset(table, date.year, standard))
+            {
+                return false;
+            }
+            daylight_saving[row] = offset > standard;
+            date.next();
+        }
+    }
+    return true;
+}
+
+extern "C" {
+
+bool calendar_columns_fill(int32_t from_epoch_day, int32_t until_epoch_day,
+    const TZID *zones, size_t zone_count, struct calendar_columns *columns)
+{
+    size_t day_count = until_epoch_day > from_epoch_day ?
+        (size_t)((int64_t)until_epoch_day - from_epoch_day) : 0;
+    calendar_date date(from_epoch_day);
+    for (size_t row = 0; row < day_count; ++row, date.next()) {
+        if (columns->epoch_days != nullptr) {
+            columns->epoch_days[row] = from_epoch_day + (int32_t)row;
+        }
+        if (columns->years != nullptr) {
+            columns->years[row] = (int32_t)date.year;
+        }
+        if (columns->months != nullptr) {
+            columns->months[row] = date.month;
+        }
+        if (columns->days_of_month != nullptr) {
+            columns->days_of_month[row] = date.day;
+        }
+        if (columns->days_of_week != nullptr) {
+            columns->days_of_week[row] = date.day_of_week;
+        }
+        if (columns->days_of_year != nullptr) {
+            columns->days_of_year[row] = date.day_of_year;
+        }
+        if (columns->week_based_years != nullptr) {
+            columns->week_based_years[row] = (int32_t)date.week_based_year;
+        }
+        if (columns->weeks != nullptr) {
+            columns->weeks[row] = date.week;
+        }
+        if (columns->quarters != nullptr) {
+            columns->quarters[row] = (date.month + 2) / 3;
+        }
+    }
+    if (columns->starts_of_day == nullptr &&
+        columns->daylight_saving == nullptr)
+    {
+        return true;
+    }
+    for (size_t z = 0; z < zone_count; ++z) {
+        auto table = compiled_zone(zones[z]);
+        if (table == nullptr) {
+            return false;
+        }
+        size_t offset = z * day_count;
+        if (!fill_zone(*table, from_epoch_day, day_count,
+            columns->starts_of_day == nullptr ? nullptr :
+                columns->starts_of_day + offset,
+            columns->daylight_saving == nullptr ? nullptr :
+                columns->daylight_saving + offset))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
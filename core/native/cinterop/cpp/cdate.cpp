@@ -10,6 +10,7 @@
 #include "date/date.h"
 #include "date/tz.h"
 #include "helper_macros.hpp"
+#include "zone_table.hpp"
 #include <cstring>
 using namespace date;
 using namespace std::chrono;
@@ -77,6 +78,49 @@ static TZID id_by_zone(const tzdb& db, const time_zone* tz)
     return id;
 }
 
+bool zone_period_at(TZID zone_id, int64_t epoch_sec, zone_period& period)
+{
+    try {
+        auto zone = zone_by_id(zone_id);
+        auto info = zone->get_info(sys_seconds(saturating(epoch_sec)));
+        period.begin = info.begin.time_since_epoch().count();
+        period.end = info.end.time_since_epoch().count();
+        period.offset = info.offset.count();
+        return true;
+    } catch (std::runtime_error e) {
+        return false;
+    }
+}
+
+bool zone_abbreviation_at(TZID zone_id, int64_t epoch_sec,
+    zone_period& period, const char *&abbreviation)
+{
+    try {
+        auto zone = zone_by_id(zone_id);
+        auto info = zone->get_info(sys_seconds(saturating(epoch_sec)));
+        period.begin = info.begin.time_since_epoch().count();
+        period.end = info.end.time_since_epoch().count();
+        period.offset = info.offset.count();
+        abbreviation = intern_abbreviation(info.abbrev);
+        return true;
+    } catch (std::runtime_error e) {
+        return false;
+    }
+}
+
+std::vector<TZID> all_zone_ids()
+{
+    std::vector<TZID> ids;
+    try {
+        auto& tzdb = get_tzdb();
+        for (TZID id = 0; id < tzdb.zones.size(); ++id) {
+            ids.push_back(id);
+        }
+    } catch (std::runtime_error e) {
+    }
+    return ids;
+}
+
 extern "C" {
 
 bool current_time(int64_t *sec, int32_t *nano)
@@ -145,47 +189,54 @@ TZID timezone_by_name(const char *zone_name)
     }
 }
 
-static int offset_at_datetime_impl(TZID zone_id, seconds sec, int *offset,
-GAP_HANDLING gap_handling)
+const char * timezone_name_by_id(TZID zone_id)
 {
     try {
-        auto zone = zone_by_id(zone_id);
-        local_seconds seconds(sec);
-        auto info = zone->get_info(seconds);
-        switch (info.result) {
-            case local_info::unique:
-                *offset = info.first.offset.count();
-                return 0;
-            case local_info::nonexistent: {
-                *offset = info.second.offset.count();
-                switch (gap_handling) {
-                    case GAP_HANDLING_MOVE_FORWARD:
-                        return info.second.offset.count() -
-                            info.first.offset.count();
-                    case GAP_HANDLING_NEXT_CORRECT: {
-                        return duration_cast<std::chrono::seconds>(
-                            info.second.begin.time_since_epoch()).count() -
-                            sec.count() + info.second.offset.count();
-                    }
-                    default:
-                        // impossible
-                        *offset = INT_MAX;
-                        return 0;
-                }
-            }
-            case local_info::ambiguous:
-                if (info.second.offset.count() != *offset)
-                    *offset = info.first.offset.count();
-                return 0;
-            default:
-                // the pattern matching above is supposedly exhaustive
-                *offset = INT_MAX;
-                return 0;
-        }
+        // The zones in the `tzdb` are never destroyed.
+        return zone_by_id(zone_id)->name().c_str();
     } catch (std::runtime_error e) {
+        return nullptr;
+    }
+}
+
+/* Resolves the local date-time with the compiled table of the zone, which
+   takes a single search in its local date-times. */
+static int offset_at_datetime_impl(TZID zone_id, seconds sec, int *offset,
+GAP_HANDLING gap_handling)
+{
+    auto table = compiled_zone(zone_id);
+    local_resolution info;
+    if (table == nullptr || !table->resolve_local(sec.count(), info)) {
         *offset = INT_MAX;
         return 0;
     }
+    switch (info.kind) {
+        case LOCAL_UNIQUE:
+            *offset = info.first.offset;
+            return 0;
+        case LOCAL_GAP: {
+            *offset = info.second.offset;
+            switch (gap_handling) {
+                case GAP_HANDLING_MOVE_FORWARD:
+                    return info.second.offset - info.first.offset;
+                case GAP_HANDLING_NEXT_CORRECT:
+                    return (int)(info.second.begin - sec.count() +
+                        info.second.offset);
+                default:
+                    // impossible
+                    *offset = INT_MAX;
+                    return 0;
+            }
+        }
+        case LOCAL_OVERLAP:
+            if (info.second.offset != *offset)
+                *offset = info.first.offset;
+            return 0;
+        default:
+            // the pattern matching above is supposedly exhaustive
+            *offset = INT_MAX;
+            return 0;
+    }
 }
 
 int offset_at_datetime(TZID zone_id, int64_t epoch_sec, int *offset)
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the functions specified in `cdate.h` using the C++20
+   `std::chrono::tzdb` directly, without the `date` library. It is an
+   alternative to `cdate.cpp` for Linux, selected with the Gradle property
+   `kotlinx.datetime.native.linuxTzBackend=chrono`, and requires a standard
+   library that implements the time zone support of C++20 (libstdc++ 14 or
+   newer). Like `cdate.cpp`, it reads the system timezone database.
+
+   The code mirrors `cdate.cpp` so that the two can be compared and, once the
+   toolchain allows it, the `date` library can be dropped. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+using namespace std::chrono;
+
+static int64_t first_instant_of_year(const year& yr) {
+    return sys_seconds{sys_days{yr/January/1}}.time_since_epoch().count();
+}
+/* The years valid for `std::chrono::year` are [-32767; 32767], the same as
+   in the `date` library, so the instants are clamped in the same way as in
+   `cdate.cpp`. */
+static const int64_t min_available_instant =
+    first_instant_of_year(++year::min());
+static const int64_t max_available_instant =
+    first_instant_of_year(--year::max());
+
+static seconds saturating(int64_t epoch_sec)
+{
+    if (epoch_sec < min_available_instant)
+        epoch_sec = min_available_instant;
+    else if (epoch_sec > max_available_instant)
+        epoch_sec = max_available_instant;
+    return seconds(epoch_sec);
+}
+
+extern "C" {
+#include "cdate.h"
+}
+
+static char * timezone_name(const time_zone& zone)
+{
+    return strdup(std::string(zone.name()).c_str());
+}
+
+static const time_zone *zone_by_id(TZID id)
+{
+    /* `get_tzdb()` returns the front of the `tzdb_list`, which only changes
+       on `reload_tzdb()`. We never call it, so the ids stay valid for the
+       lifetime of the process, just like with the `date` library. */
+    auto& tzdb = get_tzdb();
+    if (id >= tzdb.zones.size()) {
+        throw std::runtime_error("Invalid timezone id");
+    }
+    return &tzdb.zones[id];
+}
+
+static TZID id_by_zone(const tzdb& db, const time_zone* tz)
+{
+    size_t id = tz - &db.zones[0];
+    if (id >= db.zones.size()) {
+        throw std::runtime_error("The time zone is not part of the tzdb");
+    }
+    return id;
+}
+
+static void fill_period(const sys_info& info, zone_period& period)
+{
+    period.begin = info.begin.time_since_epoch().count();
+    period.end = info.end.time_since_epoch().count();
+    period.offset = info.offset.count();
+}
+
+bool zone_period_at(TZID zone_id, int64_t epoch_sec, zone_period& period)
+{
+    try {
+        auto zone = zone_by_id(zone_id);
+        fill_period(zone->get_info(sys_seconds(saturating(epoch_sec))), period);
+        return true;
+    } catch (std::runtime_error e) {
+        return false;
+    }
+}
+
+bool zone_abbreviation_at(TZID zone_id, int64_t epoch_sec,
+    zone_period& period, const char *&abbreviation)
+{
+    try {
+        auto zone = zone_by_id(zone_id);
+        auto info = zone->get_info(sys_seconds(saturating(epoch_sec)));
+        fill_period(info, period);
+        abbreviation = intern_abbreviation(info.abbrev);
+        return true;
+    } catch (std::runtime_error e) {
+        return false;
+    }
+}
+
+std::vector<TZID> all_zone_ids()
+{
+    std::vector<TZID> ids;
+    try {
+        auto& tzdb = get_tzdb();
+        for (TZID id = 0; id < tzdb.zones.size(); ++id) {
+            ids.push_back(id);
+        }
+    } catch (std::runtime_error e) {
+    }
+    return ids;
+}
+
+extern "C" {
+
+bool current_time(int64_t *sec, int32_t *nano)
+{
+    timespec tm;
+    int error = clock_gettime(CLOCK_REALTIME, &tm);
+    if (error) {
+        return false;
+    }
+    *sec = tm.tv_sec;
+    *nano = tm.tv_nsec;
+    return true;
+}
+
+char * get_system_timezone(TZID * id)
+{
+    try {
+        auto& tzdb = get_tzdb();
+        auto zone = tzdb.current_zone();
+        *id = id_by_zone(tzdb, zone);
+        return timezone_name(*zone);
+    } catch (std::runtime_error e) {
+        *id = TZID_INVALID;
+        return nullptr;
+    }
+}
+
+char ** available_zone_ids()
+{
+    try {
+        auto& tzdb = get_tzdb();
+        auto& zones = tzdb.zones;
+        char ** zones_copy = check_allocation(
+            (char **)malloc(sizeof(char *) * (zones.size() + 1)));
+        zones_copy[zones.size()] = nullptr;
+        for (unsigned long i = 0; i < zones.size(); ++i) {
+            zones_copy[i] = timezone_name(zones[i]);
+        }
+        return zones_copy;
+    } catch (std::runtime_error e) {
+        return nullptr;
+    }
+}
+
+int offset_at_instant(TZID zone_id, int64_t epoch_sec)
+{
+    try {
+        auto zone = zone_by_id(zone_id);
+        auto info = zone->get_info(sys_seconds(saturating(epoch_sec)));
+        return info.offset.count();
+    } catch (std::runtime_error e) {
+        return INT_MAX;
+    }
+}
+
+TZID timezone_by_name(const char *zone_name)
+{
+    try {
+        // Links are resolved to the zones they point to.
+        auto& tzdb = get_tzdb();
+        return id_by_zone(tzdb, tzdb.locate_zone(zone_name));
+    } catch (std::runtime_error e) {
+        return TZID_INVALID;
+    }
+}
+
+const char * timezone_name_by_id(TZID zone_id)
+{
+    try {
+        /* The zones in the `tzdb` are never destroyed, and `name()` views a
+           string owned by the zone, which is null-terminated in libstdc++. */
+        return zone_by_id(zone_id)->name().data();
+    } catch (std::runtime_error e) {
+        return nullptr;
+    }
+}
+
+/* Resolves the local date-time with the compiled table of the zone, which
+   takes a single search in its local date-times. */
+static int offset_at_datetime_impl(TZID zone_id, seconds sec, int *offset,
+GAP_HANDLING gap_handling)
+{
+    auto table = compiled_zone(zone_id);
+    local_resolution info;
+    if (table == nullptr || !table->resolve_local(sec.count(), info)) {
+        *offset = INT_MAX;
+        return 0;
+    }
+    switch (info.kind) {
+        case LOCAL_UNIQUE:
+            *offset = info.first.offset;
+            return 0;
+        case LOCAL_GAP: {
+            *offset = info.second.offset;
+            switch (gap_handling) {
+                case GAP_HANDLING_MOVE_FORWARD:
+                    return info.second.offset - info.first.offset;
+                case GAP_HANDLING_NEXT_CORRECT:
+                    return (int)(info.second.begin - sec.count() +
+                        info.second.offset);
+                default:
+                    // impossible
+                    *offset = INT_MAX;
+                    return 0;
+            }
+        }
+        case LOCAL_OVERLAP:
+            if (info.second.offset != *offset)
+                *offset = info.first.offset;
+            return 0;
+        default:
+            // the pattern matching above is supposedly exhaustive
+            *offset = INT_MAX;
+            return 0;
+    }
+}
+
+int offset_at_datetime(TZID zone_id, int64_t epoch_sec, int *offset)
+{
+    return offset_at_datetime_impl(zone_id, saturating(epoch_sec), offset,
+        GAP_HANDLING_MOVE_FORWARD);
+}
+
+int64_t at_start_of_day(TZID zone_id, int64_t epoch_sec)
+{
+    int offset = 0;
+    int trans = offset_at_datetime_impl(zone_id, saturating(epoch_sec), &offset,
+        GAP_HANDLING_NEXT_CORRECT);
+    if (offset == INT_MAX)
+        return LONG_MAX;
+    if (epoch_sec > max_available_instant || epoch_sec < min_available_instant) {
+        trans = 0;
+    }
+    return epoch_sec - offset + trans;
+}
+
+}
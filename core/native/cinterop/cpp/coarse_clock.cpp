@@ -0,0 +1,125 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the coarse clock declared in `cdate.h`.
+
+   The time is kept in a single atomic in a cache line of its own, so the
+   readers, which only load it, don't contend with anything but the ticker
+   thread storing to it once per tick. */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+extern "C" {
+#include "cdate.h"
+}
+
+static const int64_t nanos_per_second = 1000000000;
+
+struct alignas(64) published_time {
+    std::atomic<int64_t> epoch_nanos;
+};
+
+static published_time coarse_time = { {INT64_MIN} };
+
+/* The state of the ticker thread. It's never destroyed, as the thread may
+   still be running when the program exits. */
+struct ticker {
+    // Serializes starting and stopping the thread.
+    std::mutex control;
+    // Guards the fields below.
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+    std::chrono::microseconds tick{0};
+    std::thread thread;
+};
+
+static ticker& the_ticker()
+{
+    static ticker *instance = new ticker();
+    return *instance;
+}
+
+static bool publish_current_time()
+{
+    int64_t sec;
+    int32_t nano;
+    if (!current_time(&sec, &nano)) {
+        return false;
+    }
+    /* Nothing else is published along with the time, so the order of the
+       memory accesses around it doesn't matter. */
+    coarse_time.epoch_nanos.store(sec * nanos_per_second + nano,
+        std::memory_order_relaxed);
+    return true;
+}
+
+static void run_ticker(ticker *state)
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->running) {
+        // If the time can't be read, the previous one stays.
+        publish_current_time();
+        state->wake.wait_for(lock, state->tick);
+    }
+}
+
+extern "C" {
+
+bool coarse_clock_start(int32_t tick_microseconds)
+{
+    if (tick_microseconds <= 0) {
+        return false;
+    }
+    auto& state = the_ticker();
+    std::lock_guard<std::mutex> control(state.control);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.tick = std::chrono::microseconds(tick_microseconds);
+        if (state.running) {
+            state.wake.notify_one();
+            return true;
+        }
+        // The time is available as soon as this returns.
+        if (!publish_current_time()) {
+            return false;
+        }
+        state.running = true;
+    }
+    try {
+        state.thread = std::thread(run_ticker, &state);
+    } catch (std::system_error e) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.running = false;
+        coarse_time.epoch_nanos.store(INT64_MIN, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void coarse_clock_stop()
+{
+    auto& state = the_ticker();
+    std::lock_guard<std::mutex> control(state.control);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.running) {
+            return;
+        }
+        state.running = false;
+        state.wake.notify_one();
+    }
+    state.thread.join();
+    coarse_time.epoch_nanos.store(INT64_MIN, std::memory_order_relaxed);
+}
+
+int64_t coarse_clock_epoch_nanos()
+{
+    return coarse_time.epoch_nanos.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the table of leap seconds and the conversions between
+   UTC and TAI declared in `cdate.h`.
+
+   The table is immutable once loaded and is published with an atomic
+   pointer, so the conversions don't take locks. Most instants to convert are
+   after the last leap second, so that case is checked first. */
+#include "helper_macros.hpp"
+#include "tzif.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+extern "C" {
+#include "cdate.h"
+}
+#ifndef _WIN32
+#include <time.h>
+#include <sys/timex.h>
+#ifndef CLOCK_TAI
+// Supported by Linux since 3.10, but not defined by older C libraries.
+#define CLOCK_TAI 11
+#endif
+#endif
+
+/* TAI - UTC is `offsets[i]` seconds starting from the UTC instant `begins[i]`,
+   the first of which is INT64_MIN. The offset of 10 seconds in effect since
+   1972 is used for all the earlier instants. `tai_begins[i]` is the TAI
+   reading at `begins[i]`. */
+struct leap_second_table {
+    std::vector<int64_t> begins;
+    std::vector<int64_t> tai_begins;
+    std::vector<int> offsets;
+
+    void add(int64_t begin, int offset) {
+        begins.push_back(begin);
+        tai_begins.push_back(begins.size() == 1 ? INT64_MIN : begin + offset);
+        offsets.push_back(offset);
+    }
+};
+
+static const int initial_tai_offset = 10;
+
+static std::atomic<const leap_second_table *> current_table(nullptr);
+// Guards loading the tables and `loaded_tables`.
+static std::mutex tables_mutex;
+// The tables that were replaced are kept, as they may still be in use.
+static std::vector<std::unique_ptr<leap_second_table>> loaded_tables;
+static bool default_table_tried = false;
+
+static int64_t epoch_day(int64_t y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t year_of_era = y - era * 400;
+    int64_t day_of_year = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+        year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+static bool read_tzif_table(const char *path, leap_second_table& table)
+{
+    tzif_data data;
+    if (!read_tzif(path, data) || data.leap_seconds.empty()) {
+        return false;
+    }
+    table.add(INT64_MIN, initial_tai_offset);
+    int previous_correction = 0;
+    for (auto& leap : data.leap_seconds) {
+        /* The occurrences are on the time scale of the file, which counts the
+           leap seconds before them. */
+        table.add(leap.occurrence - previous_correction,
+            initial_tai_offset + leap.correction);
+        previous_correction = leap.correction;
+    }
+    return true;
+}
+
+/* Reads the `leapseconds` file of the time zone database, where each leap
+   second is described by a line like
+   `Leap  1972  Jun  30  23:59:60  +  S`. */
+static bool read_text_table(const char *path, leap_second_table& table)
+{
+    static const char *month_names[] = {"Jan", "Feb", "Mar", "Apr", "May",
+        "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    table.add(INT64_MIN, initial_tai_offset);
+    bool success = true;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "Leap", 4) != 0) {
+            continue;
+        }
+        int year, day, hours, minutes, seconds;
+        char month_name[4], sign;
+        if (sscanf(line, "Leap %d %3s %d %d:%d:%d %c", &year, month_name, &day,
+            &hours, &minutes, &seconds, &sign) != 7 ||
+            (sign != '+' && sign != '-'))
+        {
+            success = false;
+            break;
+        }
+        int month = 0;
+        while (month < 12 && strcmp(month_names[month], month_name) != 0) {
+            ++month;
+        }
+        if (month == 12) {
+            success = false;
+            break;
+        }
+        /* The time is that of the inserted or removed second, so the offset
+           changes right after it. */
+        int64_t begin = epoch_day(year, month + 1, day) * 86400 +
+            hours * 3600 + minutes * 60 + seconds + (sign == '+' ? 0 : 1);
+        table.add(begin, table.offsets.back() + (sign == '+' ? 1 : -1));
+    }
+    fclose(file);
+    return success && table.begins.size() > 1;
+}
+
+// Must be called with `tables_mutex` held.
+static bool load_table(const char *path)
+{
+    std::unique_ptr<leap_second_table> table(new leap_second_table());
+    if (!read_tzif_table(path, *table)) {
+        table.reset(new leap_second_table());
+        if (!read_text_table(path, *table)) {
+            return false;
+        }
+    }
+    current_table.store(table.get(), std::memory_order_release);
+    loaded_tables.push_back(std::move(table));
+    return true;
+}
+
+static const leap_second_table *leap_seconds()
+{
+    auto table = current_table.load(std::memory_order_acquire);
+    if (table != nullptr) {
+        return table;
+    }
+    const std::lock_guard<std::mutex> lock(tables_mutex);
+    if (!default_table_tried) {
+        default_table_tried = true;
+#ifndef _WIN32
+        load_table("/usr/share/zoneinfo/right/UTC") ||
+            load_table("/usr/share/zoneinfo/leapseconds");
+#endif
+    }
+    return current_table.load(std::memory_order_acquire);
+}
+
+static inline int64_t shift(const std::vector<int64_t>& begins,
+    const std::vector<int>& offsets, int64_t instant, int sign)
+{
+    size_t last = begins.size() - 1;
+    if (instant >= begins[last]) {
+        return instant + sign * offsets[last];
+    }
+    /* There are only a few dozen leap seconds, so counting the ones before the
+       instant without branches is faster than a binary search. */
+    size_t passed = 0;
+    for (size_t i = 1; i < last; ++i) {
+        passed += instant >= begins[i];
+    }
+    return instant + sign * offsets[passed];
+}
+
+extern "C" {
+
+bool leap_seconds_load(const char *path)
+{
+    const std::lock_guard<std::mutex> lock(tables_mutex);
+    default_table_tried = true;
+    return load_table(path);
+}
+
+bool utc_to_tai(const int64_t *utc_epoch_sec, int64_t *tai_sec, size_t count)
+{
+    auto table = leap_seconds();
+    if (table == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        tai_sec[i] = shift(table->begins, table->offsets, utc_epoch_sec[i], 1);
+    }
+    return true;
+}
+
+bool tai_to_utc(const int64_t *tai_sec, int64_t *utc_epoch_sec, size_t count)
+{
+    auto table = leap_seconds();
+    if (table == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        utc_epoch_sec[i] =
+            shift(table->tai_begins, table->offsets, tai_sec[i], -1);
+    }
+    return true;
+}
+
+bool current_time_tai(int64_t *sec, int32_t *nano)
+{
+#ifndef _WIN32
+    /* The kernel only knows the offset if something like an NTP daemon
+       told it. */
+    struct timex status;
+    memset(&status, 0, sizeof(status));
+    if (adjtimex(&status) != -1 && status.tai > 0) {
+        timespec tm;
+        if (clock_gettime(CLOCK_TAI, &tm) == 0) {
+            *sec = tm.tv_sec;
+            *nano = tm.tv_nsec;
+            return true;
+        }
+    }
+#endif
+    int64_t utc;
+    if (!current_time(&utc, nano)) {
+        return false;
+    }
+    return utc_to_tai(&utc, sec, 1);
+}
+
+}
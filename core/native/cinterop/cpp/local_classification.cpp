@@ -0,0 +1,33 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the classification of local date-times declared in
+   `cdate.h`. The date-times are resolved with the compiled table of the zone,
+   keeping the place of the previous one, so sorted date-times are processed
+   in one pass over the transitions. */
+#include "zone_table.hpp"
+
+extern "C" {
+
+bool classify_local_datetimes(TZID zone, const int64_t *local_epoch_secs,
+    size_t count, int32_t *offsets_before, int32_t *offsets_after)
+{
+    const zone_table *table = compiled_zone(zone);
+    if (table == nullptr) {
+        return false;
+    }
+    size_t cursor = 0;
+    for (size_t i = 0; i < count; ++i) {
+        local_resolution info;
+        if (!table->resolve_local_from(local_epoch_secs[i], cursor, info)) {
+            return false;
+        }
+        offsets_before[i] = info.first.offset;
+        offsets_after[i] = info.kind == LOCAL_UNIQUE ?
+            info.first.offset : info.second.offset;
+    }
+    return true;
+}
+
+}
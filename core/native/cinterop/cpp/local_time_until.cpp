@@ -0,0 +1,101 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the queries for the time until a local time of day
+   declared in `cdate.h`. The local date-times are mapped to UTC with the
+   compiled tables of the zones, so the platform is only asked for the
+   current time. */
+#include "zone_table.hpp"
+
+static const int64_t seconds_per_day = 24 * 60 * 60;
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : (a + 1) / b - 1;
+}
+
+/* The first instant not earlier than `now` when the local time in the zone is
+   `second_of_day`, or INT64_MAX if the zone is invalid. */
+static int64_t next_local_time(const zone_table& table, int second_of_day,
+    int64_t now)
+{
+    zone_period period;
+    if (!table.period_at(now, period)) {
+        return INT64_MAX;
+    }
+    int64_t today = floor_div(now + period.offset, seconds_per_day);
+    /* A transition can't move the clock by a day, so one of the next two
+       occurrences is not in the past. The third one is checked in case a
+       day is skipped. */
+    for (int64_t day = today; day < today + 3; ++day) {
+        int64_t local = day * seconds_per_day + second_of_day;
+        local_resolution info;
+        if (!table.resolve_local(local, info)) {
+            return INT64_MAX;
+        }
+        switch (info.kind) {
+            case LOCAL_UNIQUE:
+                if (local - info.first.offset >= now) {
+                    return local - info.first.offset;
+                }
+                break;
+            case LOCAL_GAP:
+                /* The time is skipped, so it is moved forward by the length
+                   of the gap, like `LocalDateTime.toInstant` does. */
+                if (local - info.first.offset >= now) {
+                    return local - info.first.offset;
+                }
+                break;
+            case LOCAL_OVERLAP:
+                if (local - info.first.offset >= now) {
+                    return local - info.first.offset;
+                }
+                if (local - info.second.offset >= now) {
+                    return local - info.second.offset;
+                }
+                break;
+        }
+    }
+    return INT64_MAX;
+}
+
+extern "C" {
+
+int64_t seconds_until_local_time(TZID zone, int32_t second_of_day)
+{
+    int64_t now;
+    int32_t nano;
+    if (!current_time(&now, &nano)) {
+        return INT64_MAX;
+    }
+    int64_t result;
+    if (!seconds_until_local_times(&zone, &second_of_day, 1, now, &result)) {
+        return INT64_MAX;
+    }
+    return result;
+}
+
+bool seconds_until_local_times(const TZID *zones,
+    const int32_t *seconds_of_day, size_t count, int64_t now_epoch_sec,
+    int64_t *results)
+{
+    bool success = true;
+    for (size_t i = 0; i < count; ++i) {
+        const zone_table *table = nullptr;
+        if (seconds_of_day[i] >= 0 && seconds_of_day[i] < seconds_per_day) {
+            table = compiled_zone(zones[i]);
+        }
+        int64_t next = table == nullptr ? INT64_MAX :
+            next_local_time(*table, seconds_of_day[i], now_epoch_sec);
+        if (next == INT64_MAX) {
+            success = false;
+            results[i] = INT64_MAX;
+        } else {
+            results[i] = next - now_epoch_sec;
+        }
+    }
+    return success;
+}
+
+}
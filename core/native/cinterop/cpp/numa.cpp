@@ -0,0 +1,125 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the detection of the NUMA topology declared in
+   `numa.hpp`. The topology is read once, so hotplugging of CPUs is not
+   noticed. */
+#include "numa.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+struct numa_topology {
+    std::vector<std::vector<int>> node_cpus;
+    // `cpu_nodes[cpu]` is the node of the CPU.
+    std::vector<size_t> cpu_nodes;
+};
+
+#ifdef __linux__
+static bool read_line(const std::string& path, std::string& line)
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char buffer[4096];
+    bool success = fgets(buffer, sizeof(buffer), file) != nullptr;
+    fclose(file);
+    if (success) {
+        line = buffer;
+    }
+    return success;
+}
+
+// Parses the lists like "0-3,8-11" used in `/sys`.
+static std::vector<int> parse_list(const std::string& list)
+{
+    std::vector<int> result;
+    const char *p = list.c_str();
+    while (*p >= '0' && *p <= '9') {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (long i = first; i <= last; ++i) {
+            result.push_back((int)i);
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return result;
+}
+
+static numa_topology read_topology()
+{
+    numa_topology topology;
+    const std::string root = "/sys/devices/system/node/";
+    std::string online;
+    if (read_line(root + "online", online)) {
+        for (int node : parse_list(online)) {
+            std::string cpus;
+            if (!read_line(root + "node" + std::to_string(node) + "/cpulist",
+                cpus))
+            {
+                continue;
+            }
+            if ((size_t)node >= topology.node_cpus.size()) {
+                topology.node_cpus.resize(node + 1);
+            }
+            topology.node_cpus[node] = parse_list(cpus);
+            for (int cpu : topology.node_cpus[node]) {
+                if ((size_t)cpu >= topology.cpu_nodes.size()) {
+                    topology.cpu_nodes.resize(cpu + 1, 0);
+                }
+                topology.cpu_nodes[cpu] = node;
+            }
+        }
+    }
+    if (topology.node_cpus.empty()) {
+        topology.node_cpus.resize(1);
+    }
+    return topology;
+}
+#else
+static numa_topology read_topology()
+{
+    numa_topology topology;
+    topology.node_cpus.resize(1);
+    return topology;
+}
+#endif
+
+static const numa_topology& topology()
+{
+    // Initialization of local statics is thread-safe.
+    static const numa_topology topology = read_topology();
+    return topology;
+}
+
+size_t numa_node_count()
+{
+    return topology().node_cpus.size();
+}
+
+size_t current_numa_node()
+{
+#ifdef __linux__
+    auto& cpu_nodes = topology().cpu_nodes;
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && (size_t)cpu < cpu_nodes.size()) {
+        return cpu_nodes[cpu];
+    }
+#endif
+    return 0;
+}
+
+std::vector<int> numa_node_cpus(size_t node)
+{
+    auto& node_cpus = topology().node_cpus;
+    return node < node_cpus.size() ? node_cpus[node] : std::vector<int>();
+}
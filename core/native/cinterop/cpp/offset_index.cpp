@@ -0,0 +1,212 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the search for the zones that had the given offsets,
+   declared in `cdate.h`.
+
+   For each offset, the time is split into segments during which the set of
+   zones with that offset stays the same, so a query is a binary search
+   followed by copying the sets of the matching segments. When several
+   observations of offsets have to be matched, the sorted sets of the
+   segments containing them are intersected. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+
+struct offset_segments {
+    /* Segment `i` is [bounds[i]; bounds[i + 1]); the zones in it are
+       zones[starts[i]], ..., zones[starts[i + 1] - 1]. The last bound
+       only ends the last segment. */
+    std::vector<int64_t> bounds;
+    std::vector<uint32_t> starts;
+    std::vector<TZID> zones;
+};
+
+struct offset_event {
+    int64_t instant;
+    TZID zone;
+    bool starts;
+
+    bool operator<(const offset_event& other) const {
+        return instant < other.instant;
+    }
+};
+
+static offset_segments build_segments(std::vector<offset_event>& events)
+{
+    offset_segments segments;
+    std::sort(events.begin(), events.end());
+    std::vector<TZID> active;
+    for (size_t i = 0; i < events.size();) {
+        int64_t instant = events[i].instant;
+        for (; i < events.size() && events[i].instant == instant; ++i) {
+            auto& event = events[i];
+            auto position = std::lower_bound(
+                active.begin(), active.end(), event.zone);
+            if (event.starts) {
+                active.insert(position, event.zone);
+            } else {
+                active.erase(position);
+            }
+        }
+        size_t previous_start = segments.starts.empty() ?
+            0 : segments.starts.back();
+        if (!segments.starts.empty() &&
+            segments.zones.size() - previous_start == active.size() &&
+            std::equal(active.begin(), active.end(),
+                segments.zones.begin() + previous_start))
+        {
+            // Nothing changed, so the previous segment continues.
+            continue;
+        }
+        segments.bounds.push_back(instant);
+        segments.starts.push_back(segments.zones.size());
+        segments.zones.insert(segments.zones.end(), active.begin(), active.end());
+    }
+    segments.starts.push_back(segments.zones.size());
+    return segments;
+}
+
+static std::unordered_map<int, offset_segments> build_index()
+{
+    std::unordered_map<int, std::vector<offset_event>> events;
+    for (auto id : all_zone_ids()) {
+        auto table = compiled_zone(id);
+        if (table == nullptr) {
+            continue;
+        }
+        for (size_t i = 0; i < table->period_count(); ++i) {
+            auto period = table->period(i);
+            auto& offset_events = events[period.offset];
+            offset_events.push_back(offset_event{period.begin, id, true});
+            offset_events.push_back(offset_event{period.end, id, false});
+        }
+    }
+    std::unordered_map<int, offset_segments> index;
+    for (auto& entry : events) {
+        index[entry.first] = build_segments(entry.second);
+    }
+    return index;
+}
+
+static const std::unordered_map<int, offset_segments>& offset_index()
+{
+    // Initialization of local statics is thread-safe.
+    static const std::unordered_map<int, offset_segments> index = build_index();
+    return index;
+}
+
+/* Finds the segment containing the given instant. Returns false if no zone
+   had the offset then. */
+static bool segment_at(const offset_segments& segments, int64_t instant,
+    const TZID*& begin, const TZID*& end)
+{
+    auto& bounds = segments.bounds;
+    size_t i = std::upper_bound(bounds.begin(), bounds.end(), instant)
+        - bounds.begin();
+    if (i == 0 || i == bounds.size()) {
+        return false;
+    }
+    --i;
+    begin = segments.zones.data() + segments.starts[i];
+    end = segments.zones.data() + segments.starts[i + 1];
+    return begin != end;
+}
+
+/* Replaces `candidates` with the zones in it that had `offset` at `instant`.
+   If `first`, all the zones that had that offset are taken. */
+static void restrict_candidates(
+    const std::unordered_map<int, offset_segments>& index,
+    int64_t instant, int offset, bool first,
+    std::vector<TZID>& candidates, std::vector<TZID>& scratch)
+{
+    auto it = index.find(offset);
+    const TZID *begin, *end;
+    if (it == index.end() || !segment_at(it->second, instant, begin, end)) {
+        candidates.clear();
+        return;
+    }
+    if (first) {
+        candidates.assign(begin, end);
+        return;
+    }
+    scratch.clear();
+    std::set_intersection(candidates.begin(), candidates.end(), begin, end,
+        std::back_inserter(scratch));
+    candidates.swap(scratch);
+}
+
+extern "C" {
+
+TZID * zones_with_offset(int offset, int64_t from_epoch_sec,
+    int64_t until_epoch_sec, size_t *count)
+{
+    std::vector<TZID> result;
+    auto& index = offset_index();
+    auto it = index.find(offset);
+    if (it != index.end() && from_epoch_sec < until_epoch_sec) {
+        auto& segments = it->second;
+        auto& bounds = segments.bounds;
+        size_t i = std::upper_bound(bounds.begin(), bounds.end(),
+            from_epoch_sec) - bounds.begin();
+        if (i > 0) {
+            --i;
+        }
+        for (; i + 1 < bounds.size() && bounds[i] < until_epoch_sec; ++i) {
+            if (bounds[i + 1] <= from_epoch_sec) {
+                continue;
+            }
+            result.insert(result.end(),
+                segments.zones.begin() + segments.starts[i],
+                segments.zones.begin() + segments.starts[i + 1]);
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    TZID *array = check_allocation(
+        (TZID *)malloc(sizeof(TZID) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(TZID) * result.size());
+    }
+    *count = result.size();
+    return array;
+}
+
+TZID * infer_zones(const int64_t *instants, const int *offsets,
+    const size_t *history_starts, size_t history_count, size_t *zone_starts)
+{
+    auto& index = offset_index();
+    std::vector<TZID> result, candidates, scratch;
+    for (size_t history = 0; history < history_count; ++history) {
+        zone_starts[history] = result.size();
+        size_t begin = history_starts[history];
+        size_t end = history_starts[history + 1];
+        if (begin >= end) {
+            // Any zone is consistent with no observations.
+            auto all = all_zone_ids();
+            result.insert(result.end(), all.begin(), all.end());
+            continue;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            restrict_candidates(index, instants[i], offsets[i], i == begin,
+                candidates, scratch);
+            if (candidates.empty()) {
+                break;
+            }
+        }
+        result.insert(result.end(), candidates.begin(), candidates.end());
+    }
+    zone_starts[history_count] = result.size();
+    TZID *array = check_allocation(
+        (TZID *)malloc(sizeof(TZID) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(TZID) * result.size());
+    }
+    return array;
+}
+
+}
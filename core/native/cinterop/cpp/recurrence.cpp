@@ -0,0 +1,246 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the expansion of recurrence rules declared in
+   `cdate.h`. The occurrences are mapped to UTC using the compiled tables of
+   the zone, so the cost of each one is a lookup in memory. */
+#include "date/date.h"
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstring>
+using namespace date;
+
+static const int64_t seconds_per_day = 24 * 60 * 60;
+
+/* The days of the years that `date` supports, -32767-01-01 and
+   32767-12-31. The dates are only computed for these days, as the epoch days
+   are `int` there. */
+static const int64_t min_epoch_day = -12687429;
+static const int64_t max_epoch_day = 11248737;
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : (a + 1) / b - 1;
+}
+
+static int64_t floor_mod(int64_t a, int64_t b)
+{
+    return a - floor_div(a, b) * b;
+}
+
+// The first multiple of `step` after `base` that is not less than `value`.
+static int64_t align_up(int64_t value, int64_t base, int64_t step)
+{
+    if (value <= base) {
+        return base;
+    }
+    return base + (value - base + step - 1) / step * step;
+}
+
+static year_month_day date_of(int64_t epoch_day)
+{
+    return year_month_day{sys_days{days{epoch_day}}};
+}
+
+static int64_t epoch_day_of(const year_month_day& ymd)
+{
+    return sys_days{ymd}.time_since_epoch().count();
+}
+
+static bool rule_is_valid(const recurrence_rule& rule)
+{
+    if (rule.interval < 1 || rule.second_of_day < 0 ||
+        rule.second_of_day >= seconds_per_day ||
+        rule.start_epoch_day < min_epoch_day ||
+        rule.start_epoch_day > max_epoch_day) {
+        return false;
+    }
+    switch (rule.frequency) {
+        case RECURRENCE_DAILY:
+            return true;
+        case RECURRENCE_WEEKLY:
+            return rule.days_of_week > 0 && rule.days_of_week < (1 << 7);
+        case RECURRENCE_MONTHLY:
+            return rule.day_of_month != 0 &&
+                rule.day_of_month >= -31 && rule.day_of_month <= 31;
+        default:
+            return false;
+    }
+}
+
+/* Calls `action` with each epoch day in [first; last], which must be within
+   the supported days, that is selected by the rule, in increasing order,
+   until it returns false. */
+template <class F>
+static void for_each_day(const recurrence_rule& rule,
+    int64_t first, int64_t last, F action)
+{
+    first = std::max(first, rule.start_epoch_day);
+    if (first > last) {
+        return;
+    }
+    switch (rule.frequency) {
+        case RECURRENCE_DAILY:
+            for (int64_t day = align_up(first, rule.start_epoch_day,
+                rule.interval); day <= last; day += rule.interval)
+            {
+                if (!action(day)) {
+                    return;
+                }
+            }
+            break;
+        case RECURRENCE_WEEKLY: {
+            // 1970-01-01 was a Thursday.
+            auto monday_of = [](int64_t day) {
+                return day - floor_mod(day + 3, 7);
+            };
+            int64_t step = 7 * (int64_t)rule.interval;
+            for (int64_t monday = align_up(monday_of(first),
+                monday_of(rule.start_epoch_day), step);
+                monday <= last; monday += step)
+            {
+                for (int i = 0; i < 7; ++i) {
+                    int64_t day = monday + i;
+                    if ((rule.days_of_week & (1 << i)) &&
+                        day >= first && day <= last && !action(day))
+                    {
+                        return;
+                    }
+                }
+            }
+            break;
+        }
+        case RECURRENCE_MONTHLY: {
+            auto month_of = [](const year_month_day& ymd) {
+                return (int64_t)(int)ymd.year() * 12 +
+                    (unsigned)ymd.month() - 1;
+            };
+            int64_t last_month = month_of(date_of(last));
+            for (int64_t month = align_up(month_of(date_of(first)),
+                month_of(date_of(rule.start_epoch_day)), rule.interval);
+                month <= last_month; month += rule.interval)
+            {
+                year y{(int)floor_div(month, 12)};
+                date::month m{(unsigned)floor_mod(month, 12) + 1};
+                int length = (int)(unsigned)
+                    year_month_day_last{y, month_day_last{m}}.day();
+                int dom = rule.day_of_month > 0 ?
+                    rule.day_of_month : length + rule.day_of_month + 1;
+                if (dom < 1 || dom > length) {
+                    continue;
+                }
+                int64_t day = epoch_day_of(
+                    year_month_day{y, m, date::day{(unsigned)dom}});
+                if (day >= first && day <= last && !action(day)) {
+                    return;
+                }
+            }
+            break;
+        }
+    }
+}
+
+static int64_t * expand(const zone_table& zone, const recurrence_rule& rule,
+    int64_t from, int64_t until, GAP_HANDLING gap_handling,
+    OVERLAP_HANDLING overlap_handling, size_t *count)
+{
+    std::vector<int64_t> result;
+    bool failed = false;
+    if (from < until) {
+        /* Offsets are less than a day in magnitude, so the occurrences in
+           range are on these dates, of which only the supported ones are
+           looked at. */
+        int64_t first = std::max(
+            floor_div(from, seconds_per_day) - 1, min_epoch_day);
+        int64_t last = std::min(
+            floor_div(until, seconds_per_day) + 1, max_epoch_day);
+        size_t days = 0;
+        for_each_day(rule, first, last, [&](int64_t day) {
+            int64_t local = day * seconds_per_day + rule.second_of_day;
+            local_resolution info;
+            if (++days > RECURRENCE_MAX_DAYS ||
+                !zone.resolve_local(local, info))
+            {
+                failed = true;
+                return false;
+            }
+            int64_t instants[2];
+            int n = 0;
+            switch (info.kind) {
+                case LOCAL_UNIQUE:
+                    instants[n++] = local - info.first.offset;
+                    break;
+                case LOCAL_GAP:
+                    switch (gap_handling) {
+                        case GAP_HANDLING_MOVE_FORWARD:
+                            instants[n++] = local - info.first.offset;
+                            break;
+                        case GAP_HANDLING_NEXT_CORRECT:
+                            instants[n++] = info.second.begin;
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+                case LOCAL_OVERLAP:
+                    if (overlap_handling != OVERLAP_HANDLING_LATER)
+                        instants[n++] = local - info.first.offset;
+                    if (overlap_handling != OVERLAP_HANDLING_EARLIER)
+                        instants[n++] = local - info.second.offset;
+                    break;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (instants[i] >= from && instants[i] < until) {
+                    result.push_back(instants[i]);
+                }
+            }
+            return true;
+        });
+    }
+    if (failed) {
+        return nullptr;
+    }
+    /* Moving out of a gap can reorder the occurrences or make them coincide
+       if the gap is a day long or more. */
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    int64_t *array = check_allocation(
+        (int64_t *)malloc(sizeof(int64_t) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(int64_t) * result.size());
+    }
+    *count = result.size();
+    return array;
+}
+
+extern "C" {
+
+int64_t * expand_recurrence(TZID zone_id, const struct recurrence_rule *rule,
+    int64_t from_epoch_sec, int64_t until_epoch_sec,
+    enum GAP_HANDLING gap_handling, enum OVERLAP_HANDLING overlap_handling,
+    size_t *count)
+{
+    auto zone = compiled_zone(zone_id);
+    if (zone == nullptr || !rule_is_valid(*rule)) {
+        return nullptr;
+    }
+    return expand(*zone, *rule, from_epoch_sec, until_epoch_sec,
+        gap_handling, overlap_handling, count);
+}
+
+int64_t * expand_recurrence_at_offset(int offset,
+    const struct recurrence_rule *rule,
+    int64_t from_epoch_sec, int64_t until_epoch_sec, size_t *count)
+{
+    if (!rule_is_valid(*rule)) {
+        return nullptr;
+    }
+    zone_table zone;
+    zone.load_fixed(offset);
+    return expand(zone, *rule, from_epoch_sec, until_epoch_sec,
+        GAP_HANDLING_MOVE_FORWARD, OVERLAP_HANDLING_EARLIER, count);
+}
+
+}
@@ -0,0 +1,406 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the timer wheel declared in `cdate.h`.
+
+   The timers are stored with their local date-time and put into buckets by
+   the instant when they fire. Precisely computing that instant for each timer
+   right away would be wasteful, as most timers are far in the future, so
+   instead, until a timer approaches, it is bucketed by a lower bound obtained
+   with the greatest offset the zone will ever have. For zones with a constant
+   offset, the bound is exact; timers in other zones are moved to the correct
+   bucket once, when they approach. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+static const int bits_per_level = 6;
+static const int slots_per_level = 1 << bits_per_level;
+// 2^42 seconds is more than a hundred thousand years.
+static const int levels = 7;
+// An extra bucket for the timers that are too far in the future.
+static const int overflow_bucket = levels * slots_per_level;
+static const int bucket_count = overflow_bucket + 1;
+
+static const int32_t timer_free = -1;
+static const int32_t timer_due = -2;
+static const int32_t timer_cancelled = -3;
+
+static const uint32_t no_timer = UINT32_MAX;
+
+static const int64_t seconds_per_day = 24 * 60 * 60;
+
+struct wheel_zone {
+    const zone_table *table;
+    // The offset used for the lower bounds of the firing instants.
+    int max_offset;
+    /* A cache of the last resolved period: local date-times in
+       [unique_begin; unique_end) occur exactly once, with `unique_offset`. */
+    int64_t unique_begin;
+    int64_t unique_end;
+    int unique_offset;
+};
+
+struct wheel_timer {
+    int64_t local;
+    // The instant of firing if `exact`, otherwise a lower bound for it.
+    int64_t fire;
+    uint64_t payload;
+    uint32_t zone;
+    // Incremented each time the slot is reused, to detect stale ids.
+    uint32_t generation;
+    uint32_t next;
+    uint32_t prev;
+    int32_t repeat_days;
+    // The bucket the timer is in, or one of the `timer_*` states.
+    int32_t bucket;
+    bool exact;
+};
+
+struct timer_wheel {
+    int64_t current;
+    std::vector<wheel_timer> timers;
+    std::vector<uint32_t> free_timers;
+    uint32_t heads[bucket_count];
+    // Bit `i` of `occupied[l]` is set if slot `i` of level `l` is not empty.
+    uint64_t occupied[levels];
+    // The timers that fired, but were not yet reported by `advance`.
+    std::vector<uint32_t> due;
+    size_t next_due = 0;
+    size_t active = 0;
+    std::vector<wheel_zone> zones;
+    std::unordered_map<TZID, uint32_t> zone_indices;
+    std::map<int, uint32_t> offset_indices;
+    std::vector<std::unique_ptr<zone_table>> fixed_tables;
+
+    explicit timer_wheel(int64_t now) : current(now) {
+        std::fill(heads, heads + bucket_count, no_timer);
+        std::fill(occupied, occupied + levels, 0);
+    }
+
+    uint32_t add_zone(const zone_table *table) {
+        wheel_zone zone;
+        zone.table = table;
+        zone.max_offset = table->max_offset_after(current);
+        zone.unique_begin = 0;
+        zone.unique_end = 0;
+        zone.unique_offset = 0;
+        zones.push_back(zone);
+        return zones.size() - 1;
+    }
+
+    void link(uint32_t i, int32_t bucket) {
+        auto& timer = timers[i];
+        timer.bucket = bucket;
+        timer.prev = no_timer;
+        timer.next = heads[bucket];
+        if (timer.next != no_timer) {
+            timers[timer.next].prev = i;
+        }
+        heads[bucket] = i;
+        if (bucket < overflow_bucket) {
+            occupied[bucket / slots_per_level] |=
+                uint64_t(1) << (bucket % slots_per_level);
+        }
+    }
+
+    void unlink(uint32_t i) {
+        auto& timer = timers[i];
+        if (timer.prev != no_timer) {
+            timers[timer.prev].next = timer.next;
+        } else {
+            heads[timer.bucket] = timer.next;
+            if (timer.next == no_timer && timer.bucket < overflow_bucket) {
+                occupied[timer.bucket / slots_per_level] &=
+                    ~(uint64_t(1) << (timer.bucket % slots_per_level));
+            }
+        }
+        if (timer.next != no_timer) {
+            timers[timer.next].prev = timer.prev;
+        }
+    }
+
+    // Takes all the timers out of the bucket, returning the first of them.
+    uint32_t detach(int32_t bucket) {
+        uint32_t first = heads[bucket];
+        heads[bucket] = no_timer;
+        if (bucket < overflow_bucket) {
+            occupied[bucket / slots_per_level] &=
+                ~(uint64_t(1) << (bucket % slots_per_level));
+        }
+        return first;
+    }
+
+    void resolve(wheel_timer& timer) {
+        auto& zone = zones[timer.zone];
+        timer.exact = true;
+        if (timer.local >= zone.unique_begin && timer.local < zone.unique_end) {
+            timer.fire = timer.local - zone.unique_offset;
+            return;
+        }
+        local_resolution info;
+        if (!zone.table->resolve_local(timer.local, info)) {
+            // Can't happen for valid zones; fire at the lower bound then.
+            return;
+        }
+        switch (info.kind) {
+            case LOCAL_UNIQUE: {
+                timer.fire = timer.local - info.first.offset;
+                // Remember the local date-times around this one.
+                zone_period previous, next;
+                auto& table = *zone.table;
+                auto& period = info.first;
+                int64_t begin_offset = period.offset, end_offset = period.offset;
+                if (period.begin != INT64_MIN &&
+                    table.period_at(period.begin - 1, previous)) {
+                    begin_offset = std::max(period.offset, previous.offset);
+                }
+                if (period.end != INT64_MAX &&
+                    table.period_at(period.end, next)) {
+                    end_offset = std::min(period.offset, next.offset);
+                }
+                zone.unique_begin = period.begin == INT64_MIN ?
+                    INT64_MIN : period.begin + begin_offset;
+                zone.unique_end = period.end == INT64_MAX ?
+                    INT64_MAX : period.end + end_offset;
+                zone.unique_offset = period.offset;
+                break;
+            }
+            case LOCAL_GAP:
+                timer.fire = info.second.begin;
+                break;
+            case LOCAL_OVERLAP:
+                timer.fire = timer.local - info.first.offset;
+                break;
+        }
+    }
+
+    // Puts the timer into the bucket corresponding to its firing instant.
+    void place(uint32_t i) {
+        auto& timer = timers[i];
+        if (!timer.exact && timer.fire - current < slots_per_level) {
+            resolve(timer);
+        }
+        if (timer.fire <= current) {
+            timer.bucket = timer_due;
+            due.push_back(i);
+            return;
+        }
+        /* The level is determined by the highest group of bits in which the
+           instant differs from the current time. */
+        uint64_t difference = uint64_t(timer.fire) ^ uint64_t(current);
+        int level = (63 - __builtin_clzll(difference)) / bits_per_level;
+        if (level >= levels) {
+            link(i, overflow_bucket);
+            return;
+        }
+        int slot = (uint64_t(timer.fire) >> (level * bits_per_level)) &
+            (slots_per_level - 1);
+        link(i, level * slots_per_level + slot);
+    }
+
+    // Places again all the timers starting with `first`.
+    void redistribute(uint32_t first) {
+        while (first != no_timer) {
+            uint32_t next = timers[first].next;
+            place(first);
+            first = next;
+        }
+    }
+
+    void advance(int64_t target) {
+        while (current < target) {
+            if (occupied[0] == 0) {
+                // Nothing can fire until the next level-1 slot is reached.
+                int64_t boundary = (current | (slots_per_level - 1)) + 1;
+                if (boundary > target) {
+                    current = target;
+                    break;
+                }
+                current = boundary - 1;
+            }
+            ++current;
+            for (int level = 1; level <= levels; ++level) {
+                int shift = level * bits_per_level;
+                if (uint64_t(current) & ((uint64_t(1) << shift) - 1)) {
+                    break;
+                }
+                if (level == levels) {
+                    redistribute(detach(overflow_bucket));
+                } else {
+                    int slot = (uint64_t(current) >> shift) &
+                        (slots_per_level - 1);
+                    redistribute(detach(level * slots_per_level + slot));
+                }
+            }
+            uint32_t expired = detach(uint64_t(current) & (slots_per_level - 1));
+            while (expired != no_timer) {
+                timers[expired].bucket = timer_due;
+                due.push_back(expired);
+                expired = timers[expired].next;
+            }
+        }
+    }
+
+    void release(uint32_t i) {
+        auto& timer = timers[i];
+        timer.bucket = timer_free;
+        timer.generation = (timer.generation + 1) & 0x7fffffff;
+        free_timers.push_back(i);
+        --active;
+    }
+
+    int64_t schedule(uint32_t zone, int64_t local, int repeat_days,
+        uint64_t payload)
+    {
+        uint32_t i;
+        if (free_timers.empty()) {
+            i = timers.size();
+            timers.push_back(wheel_timer());
+            timers[i].generation = 0;
+        } else {
+            i = free_timers.back();
+            free_timers.pop_back();
+        }
+        auto& timer = timers[i];
+        timer.local = local;
+        timer.zone = zone;
+        timer.payload = payload;
+        timer.repeat_days = repeat_days;
+        estimate(timer);
+        ++active;
+        place(i);
+        return (int64_t(timer.generation) << 32) | i;
+    }
+
+    void estimate(wheel_timer& timer) {
+        auto& zone = zones[timer.zone];
+        timer.exact = timer.local >= zone.unique_begin &&
+            timer.local < zone.unique_end;
+        timer.fire = timer.local -
+            (timer.exact ? zone.unique_offset : zone.max_offset);
+    }
+
+    bool cancel(int64_t id) {
+        if (id < 0 || uint32_t(id) >= timers.size()) {
+            return false;
+        }
+        uint32_t i = uint32_t(id);
+        auto& timer = timers[i];
+        if (timer.generation != uint32_t(id >> 32)) {
+            return false;
+        }
+        switch (timer.bucket) {
+            case timer_free:
+            case timer_cancelled:
+                return false;
+            case timer_due:
+                // Released when it's taken out of `due`.
+                timer.bucket = timer_cancelled;
+                --active;
+                return true;
+            default:
+                unlink(i);
+                release(i);
+                return true;
+        }
+    }
+
+    size_t report(uint64_t *fired, size_t capacity) {
+        size_t count = 0;
+        while (count < capacity && next_due < due.size()) {
+            uint32_t i = due[next_due++];
+            auto& timer = timers[i];
+            if (timer.bucket == timer_cancelled) {
+                ++active;
+                release(i);
+                continue;
+            }
+            fired[count++] = timer.payload;
+            if (timer.repeat_days > 0) {
+                timer.local += timer.repeat_days * seconds_per_day;
+                estimate(timer);
+                place(i);
+            } else {
+                release(i);
+            }
+        }
+        if (next_due == due.size()) {
+            due.clear();
+            next_due = 0;
+        }
+        return count;
+    }
+};
+
+extern "C" {
+
+struct timer_wheel * timer_wheel_create(int64_t now_epoch_sec)
+{
+    return check_allocation(new (std::nothrow) timer_wheel(now_epoch_sec));
+}
+
+void timer_wheel_destroy(struct timer_wheel *wheel)
+{
+    delete wheel;
+}
+
+int64_t timer_wheel_schedule(struct timer_wheel *wheel, TZID zone_id,
+    int64_t local_epoch_sec, int repeat_days, uint64_t payload)
+{
+    auto it = wheel->zone_indices.find(zone_id);
+    uint32_t zone;
+    if (it != wheel->zone_indices.end()) {
+        zone = it->second;
+    } else {
+        auto table = compiled_zone(zone_id);
+        if (table == nullptr) {
+            return -1;
+        }
+        zone = wheel->add_zone(table);
+        wheel->zone_indices[zone_id] = zone;
+    }
+    return wheel->schedule(zone, local_epoch_sec, repeat_days, payload);
+}
+
+int64_t timer_wheel_schedule_at_offset(struct timer_wheel *wheel, int offset,
+    int64_t local_epoch_sec, int repeat_days, uint64_t payload)
+{
+    auto it = wheel->offset_indices.find(offset);
+    uint32_t zone;
+    if (it != wheel->offset_indices.end()) {
+        zone = it->second;
+    } else {
+        std::unique_ptr<zone_table> table(new zone_table());
+        table->load_fixed(offset);
+        zone = wheel->add_zone(table.get());
+        wheel->fixed_tables.push_back(std::move(table));
+        wheel->offset_indices[offset] = zone;
+    }
+    return wheel->schedule(zone, local_epoch_sec, repeat_days, payload);
+}
+
+bool timer_wheel_cancel(struct timer_wheel *wheel, int64_t timer_id)
+{
+    return wheel->cancel(timer_id);
+}
+
+size_t timer_wheel_advance(struct timer_wheel *wheel, int64_t now_epoch_sec,
+    uint64_t *fired, size_t capacity)
+{
+    wheel->advance(now_epoch_sec);
+    return wheel->report(fired, capacity);
+}
+
+size_t timer_wheel_size(const struct timer_wheel *wheel)
+{
+    return wheel->active;
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the comparison of two versions of the time zone
+   database, declared in `cdate.h`.
+
+   The zone names of both versions are sorted, and so are the periods of each
+   zone, so everything is found in a single pass over each. The zones whose
+   tables are shared by the versions are known to be the same without looking
+   at their periods. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstring>
+
+static void add_difference(std::vector<tzdb_difference>& result,
+    TZID old_zone, TZID new_zone, int64_t begin, int64_t end)
+{
+    if (!result.empty()) {
+        auto& last = result.back();
+        if (last.old_zone == old_zone && last.new_zone == new_zone &&
+            last.end == begin)
+        {
+            last.end = end;
+            return;
+        }
+    }
+    tzdb_difference difference;
+    difference.old_zone = old_zone;
+    difference.new_zone = new_zone;
+    difference.begin = begin;
+    difference.end = end;
+    result.push_back(difference);
+}
+
+/* Appends the ranges in [from; until) where the offsets of the two tables
+   differ. Both tables cover all the instants. */
+static void compare_tables(const zone_table& old_table,
+    const zone_table& new_table, TZID old_zone, TZID new_zone,
+    int64_t from, int64_t until, std::vector<tzdb_difference>& result)
+{
+    auto first_period = [from](const zone_table& table) {
+        size_t i = 0;
+        while (i + 1 < table.period_count() && table.period(i + 1).begin <= from) {
+            ++i;
+        }
+        return i;
+    };
+    size_t i = first_period(old_table), j = first_period(new_table);
+    int64_t begin = from;
+    while (begin < until) {
+        auto old_period = old_table.period(i);
+        auto new_period = new_table.period(j);
+        int64_t end = std::min(std::min(old_period.end, new_period.end), until);
+        if (old_period.offset != new_period.offset) {
+            add_difference(result, old_zone, new_zone, begin, end);
+        }
+        if (old_period.end == end) {
+            ++i;
+        }
+        if (new_period.end == end) {
+            ++j;
+        }
+        begin = end;
+    }
+}
+
+extern "C" {
+
+struct tzdb_difference * tzdb_version_diff(TZDB_VERSION old_version,
+    TZDB_VERSION new_version, int64_t from_epoch_sec, int64_t until_epoch_sec,
+    size_t *count)
+{
+    size_t old_count = tzdb_version_zone_count(old_version);
+    size_t new_count = tzdb_version_zone_count(new_version);
+    if (old_count == 0 || new_count == 0) {
+        return nullptr;
+    }
+    std::vector<tzdb_difference> result;
+    TZID i = 0, j = 0;
+    while (i < old_count || j < new_count) {
+        int comparison = i == old_count ? 1 : j == new_count ? -1 :
+            strcmp(tzdb_version_zone_name(old_version, i),
+                tzdb_version_zone_name(new_version, j));
+        if (comparison < 0) {
+            // Removed zones differ everywhere.
+            add_difference(result, i++, TZID_INVALID,
+                from_epoch_sec, until_epoch_sec);
+        } else if (comparison > 0) {
+            add_difference(result, TZID_INVALID, j++,
+                from_epoch_sec, until_epoch_sec);
+        } else {
+            auto old_table = versioned_zone(old_version, i);
+            auto new_table = versioned_zone(new_version, j);
+            if (old_table != new_table) {
+                compare_tables(*old_table, *new_table, i, j,
+                    from_epoch_sec, until_epoch_sec, result);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    if (from_epoch_sec >= until_epoch_sec) {
+        result.clear();
+    }
+    auto array = check_allocation((tzdb_difference *)malloc(
+        sizeof(tzdb_difference) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(tzdb_difference) * result.size());
+    }
+    *count = result.size();
+    return array;
+}
+
+}
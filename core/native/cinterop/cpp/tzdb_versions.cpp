@@ -0,0 +1,285 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements loading several versions of the time zone database at
+   once, declared in `cdate.h`.
+
+   Each version is a sorted list of zone names, the index in which is the id of
+   the zone in that version, and the tables of the zones. The tables are shared
+   between all the versions that have the same rules for a zone, so loading
+   versions that only differ in a few zones takes little memory. The loaded
+   versions are never modified, so they are read without locking. */
+#include "helper_macros.hpp"
+#include "tzif.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+struct tzdb_version {
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<const zone_table>> zones;
+};
+
+// More versions than that are not expected to be needed by one process.
+static const size_t max_versions = 64;
+static std::atomic<const tzdb_version *> versions[max_versions];
+static std::atomic<size_t> version_count(0);
+
+// Guards loading the versions and `shared_tables`.
+static std::mutex versions_mutex;
+// The tables of all the loaded versions, by the hashes of their contents.
+static std::unordered_multimap<uint64_t, std::shared_ptr<const zone_table>>
+    shared_tables;
+
+static bool is_ignored(const std::string& name)
+{
+    /* The same zones with different rules for leap seconds, and aliases that
+       are not zones in their own right. */
+    return name.empty() || name[0] == '.' || name == "posix" ||
+        name == "right" || name == "posixrules" || name == "localtime" ||
+        name == "Factory";
+}
+
+/* Calls `callback` with the path of each file in `directory` and its
+   subdirectories, relative to `directory`. */
+template <typename F>
+static void for_each_file(const std::string& directory,
+    const std::string& prefix, F callback)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA((directory + "\\*").c_str(), &entry);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    do {
+        std::string name = entry.cFileName;
+        if (is_ignored(name)) {
+            continue;
+        }
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            for_each_file(directory + "\\" + name, prefix + name + "/",
+                callback);
+        } else {
+            callback(directory + "\\" + name, prefix + name);
+        }
+    } while (FindNextFileA(handle, &entry));
+    FindClose(handle);
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (is_ignored(name)) {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            for_each_file(path, prefix + name + "/", callback);
+        } else if (S_ISREG(info.st_mode)) {
+            callback(path, prefix + name);
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+static uint64_t hash_of(const tzif_data& data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < data.begins.size(); ++i) {
+        hash = (hash ^ (uint64_t)data.begins[i]) * 1099511628211ULL;
+        hash = (hash ^ (uint64_t)(int64_t)data.offsets[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool has_periods(const zone_table& table, const tzif_data& data)
+{
+    if (table.period_count() != data.begins.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < data.begins.size(); ++i) {
+        auto period = table.period(i);
+        if (period.begin != data.begins[i] || period.offset != data.offsets[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Must be called with `versions_mutex` held.
+static std::shared_ptr<const zone_table> shared_table(tzif_data& data)
+{
+    uint64_t hash = hash_of(data);
+    auto range = shared_tables.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (has_periods(*it->second, data)) {
+            return it->second;
+        }
+    }
+    std::shared_ptr<zone_table> table(new zone_table());
+    table->load_periods(std::move(data.begins), std::move(data.offsets));
+    shared_tables.emplace(hash, table);
+    return table;
+}
+
+static const tzdb_version *version_by_id(TZDB_VERSION version)
+{
+    if (version >= version_count.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return versions[version].load(std::memory_order_acquire);
+}
+
+const zone_table *versioned_zone(TZDB_VERSION version, TZID zone)
+{
+    auto loaded = version_by_id(version);
+    if (loaded == nullptr || zone >= loaded->zones.size()) {
+        return nullptr;
+    }
+    return loaded->zones[zone].get();
+}
+
+extern "C" {
+
+TZDB_VERSION tzdb_version_load(const char *directory)
+{
+    std::vector<std::pair<std::string, tzif_data>> files;
+    for_each_file(directory, "", [&](const std::string& path,
+        const std::string& name)
+    {
+        tzif_data data;
+        // Other files, like `zone.tab`, are not in the TZif format.
+        if (read_tzif(path.c_str(), data)) {
+            files.push_back(std::make_pair(name, std::move(data)));
+        }
+    });
+    if (files.empty()) {
+        return TZDB_VERSION_INVALID;
+    }
+    std::sort(files.begin(), files.end(),
+        [](const std::pair<std::string, tzif_data>& a,
+            const std::pair<std::string, tzif_data>& b)
+        {
+            return a.first < b.first;
+        });
+    const std::lock_guard<std::mutex> lock(versions_mutex);
+    size_t id = version_count.load(std::memory_order_relaxed);
+    if (id == max_versions) {
+        return TZDB_VERSION_INVALID;
+    }
+    std::unique_ptr<tzdb_version> version(new tzdb_version());
+    for (auto& file : files) {
+        version->names.push_back(file.first);
+        version->zones.push_back(shared_table(file.second));
+    }
+    versions[id].store(version.release(), std::memory_order_release);
+    version_count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+size_t tzdb_version_zone_count(TZDB_VERSION version)
+{
+    auto loaded = version_by_id(version);
+    return loaded == nullptr ? 0 : loaded->names.size();
+}
+
+TZID tzdb_version_zone_by_name(TZDB_VERSION version, const char *zone_name)
+{
+    auto loaded = version_by_id(version);
+    if (loaded == nullptr) {
+        return TZID_INVALID;
+    }
+    auto& names = loaded->names;
+    auto it = std::lower_bound(names.begin(), names.end(), zone_name,
+        [](const std::string& name, const char *key) {
+            return strcmp(name.c_str(), key) < 0;
+        });
+    if (it == names.end() || *it != zone_name) {
+        return TZID_INVALID;
+    }
+    return it - names.begin();
+}
+
+const char * tzdb_version_zone_name(TZDB_VERSION version, TZID zone)
+{
+    auto loaded = version_by_id(version);
+    if (loaded == nullptr || zone >= loaded->names.size()) {
+        return nullptr;
+    }
+    return loaded->names[zone].c_str();
+}
+
+int tzdb_version_offset_at_instant(TZDB_VERSION version, TZID zone,
+    int64_t epoch_sec)
+{
+    auto table = versioned_zone(version, zone);
+    zone_period period;
+    if (table == nullptr || !table->period_at(epoch_sec, period)) {
+        return INT_MAX;
+    }
+    return period.offset;
+}
+
+int tzdb_version_offset_at_datetime(TZDB_VERSION version, TZID zone,
+    int64_t epoch_sec, int *offset)
+{
+    auto table = versioned_zone(version, zone);
+    local_resolution resolution;
+    if (table == nullptr || !table->resolve_local(epoch_sec, resolution)) {
+        *offset = INT_MAX;
+        return 0;
+    }
+    switch (resolution.kind) {
+        case LOCAL_UNIQUE:
+            *offset = resolution.first.offset;
+            return 0;
+        case LOCAL_GAP:
+            *offset = resolution.second.offset;
+            return resolution.second.offset - resolution.first.offset;
+        default:
+            if (resolution.second.offset != *offset) {
+                *offset = resolution.first.offset;
+            }
+            return 0;
+    }
+}
+
+int64_t tzdb_version_at_start_of_day(TZDB_VERSION version, TZID zone,
+    int64_t midnight_epoch_sec)
+{
+    auto table = versioned_zone(version, zone);
+    local_resolution resolution;
+    if (table == nullptr ||
+        !table->resolve_local(midnight_epoch_sec, resolution))
+    {
+        return INT64_MAX;
+    }
+    if (resolution.kind == LOCAL_GAP) {
+        // The day starts when the gap ends.
+        return resolution.second.begin;
+    }
+    return midnight_epoch_sec - resolution.first.offset;
+}
+
+}
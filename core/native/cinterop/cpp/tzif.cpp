@@ -0,0 +1,433 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the reader of TZif files declared in `tzif.hpp`.
+
+   Only the version 2+ data block is used when it is present, as it has 64-bit
+   transition times. The footer of such files is a POSIX TZ string describing
+   the transitions after the last stored one; they are computed here year by
+   year. */
+#include "tzif.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+// The number of days since 1970-01-01 of the given date in the ISO calendar.
+int64_t epoch_day(int64_t y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t year_of_era = y - era * 400;
+    int64_t day_of_year = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+        year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+bool is_leap(int64_t y)
+{
+    return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+int days_in_month(int64_t y, int m)
+{
+    static const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && is_leap(y) ? 29 : lengths[m - 1];
+}
+
+// 0 is Sunday, as in POSIX TZ strings.
+int day_of_week(int64_t epoch_day)
+{
+    int64_t result = (epoch_day + 4) % 7;
+    return (int)(result < 0 ? result + 7 : result);
+}
+
+class byte_reader {
+public:
+    byte_reader(const std::vector<unsigned char>& bytes):
+        bytes(bytes), position(0) {}
+
+    bool has(size_t count) const { return bytes.size() - position >= count; }
+
+    void skip(size_t count) { position += count; }
+
+    uint64_t read(size_t size) {
+        uint64_t result = 0;
+        for (size_t i = 0; i < size; ++i) {
+            result = result << 8 | bytes[position++];
+        }
+        return result;
+    }
+
+    std::string rest() const {
+        return std::string(bytes.begin() + position, bytes.end());
+    }
+
+private:
+    const std::vector<unsigned char>& bytes;
+    size_t position;
+};
+
+struct tzif_header {
+    char version;
+    uint32_t isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+
+    bool read(byte_reader& reader) {
+        if (!reader.has(44)) {
+            return false;
+        }
+        if (reader.read(4) != 0x545a6966) { // "TZif"
+            return false;
+        }
+        version = (char)reader.read(1);
+        reader.skip(15);
+        isutcnt = (uint32_t)reader.read(4);
+        isstdcnt = (uint32_t)reader.read(4);
+        leapcnt = (uint32_t)reader.read(4);
+        timecnt = (uint32_t)reader.read(4);
+        typecnt = (uint32_t)reader.read(4);
+        charcnt = (uint32_t)reader.read(4);
+        return typecnt > 0;
+    }
+
+    // The size of the data block that follows, for times of `time_size`.
+    size_t data_size(size_t time_size) const {
+        return timecnt * time_size + timecnt + typecnt * 6 + charcnt +
+            leapcnt * (time_size + 4) + isstdcnt + isutcnt;
+    }
+};
+
+/* A rule of a POSIX TZ string for the day of the year of a transition. */
+struct tz_rule_date {
+    enum { JULIAN_NO_LEAP, ZERO_BASED, MONTH_WEEK_DAY } kind;
+    int day, week, month;
+    // The local time of the transition, in seconds, possibly negative.
+    int time;
+
+    // The epoch day of the transition in the given year.
+    int64_t in_year(int64_t y) const {
+        switch (kind) {
+            case JULIAN_NO_LEAP:
+                // February 29 is never counted.
+                return epoch_day(y, 1, 1) + day - 1 +
+                    (is_leap(y) && day >= 60 ? 1 : 0);
+            case ZERO_BASED:
+                return epoch_day(y, 1, 1) + day;
+            default: {
+                int64_t first = epoch_day(y, month, 1);
+                int64_t result = first + (day - day_of_week(first) + 7) % 7 +
+                    (week - 1) * 7;
+                // The fifth week means the last one.
+                while (result >= first + days_in_month(y, month)) {
+                    result -= 7;
+                }
+                return result;
+            }
+        }
+    }
+};
+
+struct tz_string {
+    int std_offset;
+    bool has_dst;
+    int dst_offset;
+    tz_rule_date start, end;
+};
+
+class tz_string_parser {
+public:
+    tz_string_parser(const std::string& text): text(text), position(0) {}
+
+    bool parse(tz_string& result) {
+        if (!name() || !posix_offset(result.std_offset)) {
+            return false;
+        }
+        result.has_dst = false;
+        if (at_end()) {
+            return true;
+        }
+        result.has_dst = true;
+        if (!name()) {
+            return false;
+        }
+        result.dst_offset = result.std_offset + 3600;
+        if (!at_end() && peek() != ',' && !posix_offset(result.dst_offset)) {
+            return false;
+        }
+        if (at_end()) {
+            // The rules that POSIX specifies as the default ones.
+            return rule_date("M3.2.0", result.start) &&
+                rule_date("M11.1.0", result.end);
+        }
+        if (!consume(',') || !rule_date(result.start) || !consume(',') ||
+            !rule_date(result.end))
+        {
+            return false;
+        }
+        return at_end();
+    }
+
+private:
+    const std::string& text;
+    size_t position;
+
+    bool at_end() const { return position >= text.size(); }
+    char peek() const { return text[position]; }
+
+    bool consume(char c) {
+        if (!at_end() && peek() == c) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    bool name() {
+        if (consume('<')) {
+            while (!at_end() && peek() != '>') {
+                ++position;
+            }
+            return consume('>');
+        }
+        size_t start = position;
+        while (!at_end() && isalpha((unsigned char)peek())) {
+            ++position;
+        }
+        return position - start >= 3;
+    }
+
+    bool number(int& result, int max_digits) {
+        size_t start = position;
+        result = 0;
+        while (!at_end() && isdigit((unsigned char)peek()) &&
+            position - start < (size_t)max_digits)
+        {
+            result = result * 10 + (peek() - '0');
+            ++position;
+        }
+        return position > start;
+    }
+
+    // [+|-]hh[:mm[:ss]], hours being up to 167 for times of transitions.
+    bool time(int& result) {
+        int sign = 1;
+        if (consume('-')) {
+            sign = -1;
+        } else {
+            consume('+');
+        }
+        int hours, minutes = 0, seconds = 0;
+        if (!number(hours, 3)) {
+            return false;
+        }
+        if (consume(':')) {
+            if (!number(minutes, 2)) {
+                return false;
+            }
+            if (consume(':') && !number(seconds, 2)) {
+                return false;
+            }
+        }
+        result = sign * (hours * 3600 + minutes * 60 + seconds);
+        return true;
+    }
+
+    // POSIX offsets are positive to the west of Greenwich.
+    bool posix_offset(int& result) {
+        if (!time(result)) {
+            return false;
+        }
+        result = -result;
+        return true;
+    }
+
+    static bool rule_date(const char *text, tz_rule_date& result) {
+        std::string string(text);
+        tz_string_parser parser(string);
+        return parser.rule_date(result);
+    }
+
+    bool rule_date(tz_rule_date& result) {
+        if (consume('J')) {
+            result.kind = tz_rule_date::JULIAN_NO_LEAP;
+            if (!number(result.day, 3) || result.day < 1 || result.day > 365) {
+                return false;
+            }
+        } else if (consume('M')) {
+            result.kind = tz_rule_date::MONTH_WEEK_DAY;
+            if (!number(result.month, 2) || !consume('.') ||
+                !number(result.week, 1) || !consume('.') ||
+                !number(result.day, 1) ||
+                result.month < 1 || result.month > 12 ||
+                result.week < 1 || result.week > 5 || result.day > 6)
+            {
+                return false;
+            }
+        } else {
+            result.kind = tz_rule_date::ZERO_BASED;
+            if (!number(result.day, 3) || result.day > 365) {
+                return false;
+            }
+        }
+        result.time = 2 * 3600;
+        return !consume('/') || time(result.time);
+    }
+};
+
+// The year containing the instant, possibly off by one near its bounds.
+int64_t approximate_year_of(int64_t epoch_sec)
+{
+    return 1970 + epoch_sec / 31556952;
+}
+
+void append(tzif_data& data, int64_t begin, int offset)
+{
+    if (data.offsets.back() != offset) {
+        data.begins.push_back(begin);
+        data.offsets.push_back(offset);
+    }
+}
+
+/* Appends the transitions after the last stored one that the rules of `tz`
+   define. The DST periods of consecutive years are merged first, so rules
+   that keep DST all year produce no transitions. */
+void expand(const tz_string& tz, tzif_data& data)
+{
+    int64_t last = data.begins.back();
+    if (!tz.has_dst) {
+        // The last stored offset stays.
+        return;
+    }
+    // There was no DST before the twentieth century.
+    int64_t first_year = last < epoch_day(1900, 1, 1) * 86400 ?
+        1900 : approximate_year_of(last) - 1;
+    int64_t last_year = approximate_year_of(compiled_until);
+    auto instant = [&](const tz_rule_date& rule, int64_t y, int offset) {
+        return rule.in_year(y) * 86400 + rule.time - offset;
+    };
+    std::vector<std::pair<int64_t, int64_t>> dst;
+    for (int64_t y = first_year; y <= last_year; ++y) {
+        int64_t start = instant(tz.start, y, tz.std_offset);
+        int64_t end = instant(tz.end, y, tz.dst_offset);
+        if (end < start) {
+            // DST in the southern hemisphere lasts until the next year.
+            end = instant(tz.end, y + 1, tz.dst_offset);
+        }
+        if (!dst.empty() && dst.back().second >= start) {
+            dst.back().second = std::max(dst.back().second, end);
+        } else {
+            dst.push_back(std::make_pair(start, end));
+        }
+    }
+    for (auto& period : dst) {
+        if (period.second <= last) {
+            continue;
+        }
+        if (period.first > last) {
+            append(data, period.first, tz.dst_offset);
+        }
+        append(data, period.second, tz.std_offset);
+        if (period.second >= compiled_until) {
+            break;
+        }
+    }
+}
+
+bool read_file(const char *path, std::vector<unsigned char>& bytes)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    unsigned char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    bool success = !ferror(file);
+    fclose(file);
+    return success;
+}
+
+}
+
+bool read_tzif(const char *path, tzif_data& data)
+{
+    std::vector<unsigned char> bytes;
+    if (!read_file(path, bytes)) {
+        return false;
+    }
+    byte_reader reader(bytes);
+    tzif_header header;
+    if (!header.read(reader)) {
+        return false;
+    }
+    size_t time_size = 4;
+    if (header.version >= '2') {
+        // The version 1 block is only there for older readers.
+        size_t size = header.data_size(4);
+        if (!reader.has(size)) {
+            return false;
+        }
+        reader.skip(size);
+        if (!header.read(reader)) {
+            return false;
+        }
+        time_size = 8;
+    }
+    if (!reader.has(header.data_size(time_size))) {
+        return false;
+    }
+    auto read_time = [&]() {
+        uint64_t value = reader.read(time_size);
+        return time_size == 4 ? (int64_t)(int32_t)value : (int64_t)value;
+    };
+    std::vector<int64_t> times(header.timecnt);
+    for (auto& time : times) {
+        time = read_time();
+    }
+    std::vector<uint8_t> type_indices(header.timecnt);
+    for (auto& index : type_indices) {
+        index = (uint8_t)reader.read(1);
+        if (index >= header.typecnt) {
+            return false;
+        }
+    }
+    std::vector<int> type_offsets(header.typecnt);
+    for (auto& offset : type_offsets) {
+        offset = (int)(int32_t)reader.read(4);
+        reader.skip(2); // isdst and desigidx
+    }
+    reader.skip(header.charcnt);
+    data.leap_seconds.clear();
+    for (uint32_t i = 0; i < header.leapcnt; ++i) {
+        tzif_leap_second leap;
+        leap.occurrence = read_time();
+        leap.correction = (int)(int32_t)reader.read(4);
+        data.leap_seconds.push_back(leap);
+    }
+    reader.skip(header.isstdcnt + header.isutcnt);
+    // Local time type 0 is in effect before the first transition.
+    data.begins.assign(1, INT64_MIN);
+    data.offsets.assign(1, type_offsets[0]);
+    for (uint32_t i = 0; i < header.timecnt; ++i) {
+        append(data, times[i], type_offsets[type_indices[i]]);
+    }
+    if (header.version >= '2') {
+        // The footer is the POSIX TZ string between two newlines.
+        std::string footer = reader.rest();
+        if (footer.size() >= 2 && footer[0] == '\n') {
+            footer = footer.substr(1, footer.find('\n', 1) - 1);
+            tz_string tz;
+            if (!footer.empty() && tz_string_parser(footer).parse(tz)) {
+                expand(tz, data);
+            }
+        }
+    }
+    return true;
+}
@@ -17,6 +17,8 @@
 #include <string>
 #include <cstring>
 #include <set>
+#include <algorithm>
+#include <cstdlib>
 #ifdef DEBUG
 #include <iostream>
 #endif
@@ -26,6 +28,7 @@
 #include "date/date.h"
 #include "helper_macros.hpp"
 #include "windows_zones.hpp"
+#include "zone_table.hpp"
 extern "C" {
 #include "cdate.h"
 }
@@ -66,6 +69,20 @@ static TZID id_by_name(const std::string& name)
     }
 }
 
+/* Returns the standard timezone names indexed by their ids. The C strings
+   have static lifetime, as `zone_ids` is immutable. */
+static const std::vector<const char *>& names_by_id()
+{
+    static const std::vector<const char *> names = [] {
+        std::vector<const char *> names(zone_ids.size());
+        for (auto& entry : zone_ids) {
+            names[entry.second] = entry.first.c_str();
+        }
+        return names;
+    }();
+    return names;
+}
+
 /* Returns a standard timezone name given a Windows registry key name.
    The returned C string is guaranteed to have static lifetime. */
 static const char *native_name_to_standard_name(const std::string& native) {
@@ -278,6 +295,114 @@ static int offset_at_systime(DYNAMIC_TIME_ZONE_INFORMATION& dtzi,
     return -bias * 60;
 }
 
+static int64_t first_instant_of_year(int year)
+{
+    return date::sys_seconds{date::sys_days{
+        date::year{year}/date::January/1}}.time_since_epoch().count();
+}
+
+/* WinAPI only works with dates in years [1601; 30827]. Everything outside of
+   them is considered to be the same as the boundary years. */
+static const int64_t min_windows_instant = first_instant_of_year(1601);
+static const int64_t max_windows_instant = first_instant_of_year(30827);
+
+/* Computes the UTC instants of the transitions to the daylight saving time
+   and back in the given year. Returns false if there are no transitions. */
+static bool transitions_in_year(DYNAMIC_TIME_ZONE_INFORMATION& dtzi,
+    int year, int64_t& daylight, int64_t& standard)
+{
+    TRANSITIONS_INFO trans{};
+    if (!GetTimeZoneInformationForYear(year, &dtzi, &trans.tzi)) {
+        return false;
+    }
+    if (trans.tzi.StandardDate.wMonth == 0) {
+        return false;
+    }
+    get_transition_date(year, trans.tzi.StandardDate, trans.standard_local);
+    get_transition_date(year, trans.tzi.DaylightDate, trans.daylight_local);
+    // See `is_daylight_time` for the explanation.
+    standard = systemtime_to_unix_time(trans.standard_local) +
+        (trans.tzi.Bias + trans.tzi.DaylightBias) * 60;
+    daylight = systemtime_to_unix_time(trans.daylight_local) +
+        (trans.tzi.Bias + trans.tzi.StandardBias) * 60;
+    return true;
+}
+
+bool zone_period_at(TZID zone_id, int64_t epoch_sec, zone_period& period)
+{
+    DYNAMIC_TIME_ZONE_INFORMATION dtzi{};
+    if (!time_zone_by_id(zone_id, dtzi)) {
+        return false;
+    }
+    int64_t clamped = std::min(std::max(epoch_sec, min_windows_instant),
+        max_windows_instant - 1);
+    SYSTEMTIME systime;
+    unix_time_to_systemtime(clamped, systime);
+    TRANSITIONS_INFO ts{};
+    period.offset = offset_at_systime(dtzi, ts, systime);
+    if (period.offset == INT_MAX) {
+        return false;
+    }
+    /* The rules can differ from year to year, so the starts of the years are
+       treated as transitions. Neighboring years are also checked, as the
+       transitions are in local time and can happen on the other side of the
+       start of a year in UTC. */
+    int year = systime.wYear;
+    period.begin = year == 1601 ? INT64_MIN : first_instant_of_year(year);
+    period.end = year == 30826 ? INT64_MAX : first_instant_of_year(year + 1);
+    for (int y = year - 1; y <= year + 1; ++y) {
+        int64_t transitions[2];
+        if (!transitions_in_year(dtzi, y, transitions[0], transitions[1])) {
+            continue;
+        }
+        for (auto transition : transitions) {
+            if (transition <= clamped && transition > period.begin) {
+                period.begin = transition;
+            } else if (transition > clamped && transition < period.end) {
+                period.end = transition;
+            }
+        }
+    }
+    return true;
+}
+
+/* Windows doesn't provide abbreviations, so the offsets are written the way
+   the time zone database does for the zones that don't have them either,
+   like `+01` or `-0930`. */
+bool zone_abbreviation_at(TZID zone_id, int64_t epoch_sec,
+    zone_period& period, const char *&abbreviation)
+{
+    if (!zone_period_at(zone_id, epoch_sec, period)) {
+        return false;
+    }
+    if (period.offset == 0) {
+        abbreviation = intern_abbreviation("UTC");
+        return true;
+    }
+    int magnitude = std::abs(period.offset);
+    char buffer[16];
+    int length = snprintf(buffer, sizeof(buffer), "%c%02d",
+        period.offset < 0 ? '-' : '+', magnitude / 3600);
+    if (magnitude % 3600 != 0) {
+        snprintf(buffer + length, sizeof(buffer) - length, "%02d",
+            magnitude / 60 % 60);
+    }
+    abbreviation = intern_abbreviation(buffer);
+    return true;
+}
+
+std::vector<TZID> all_zone_ids()
+{
+    std::vector<TZID> ids;
+    DYNAMIC_TIME_ZONE_INFORMATION dtzi{};
+    for (TZID id = 0; id < zone_ids.size(); ++id) {
+        if (time_zone_by_id(id, dtzi)) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
 extern "C" {
 
 bool current_time(int64_t *sec, int32_t *nano)
@@ -361,6 +486,15 @@ TZID timezone_by_name(const char *zone_name)
     }
 }
 
+const char * timezone_name_by_id(TZID zone_id)
+{
+    DYNAMIC_TIME_ZONE_INFORMATION dtzi{};
+    if (!time_zone_by_id(zone_id, dtzi)) {
+        return nullptr;
+    }
+    return names_by_id()[zone_id];
+}
+
 static int offset_at_datetime_impl(TZID zone_id, int64_t epoch_sec, int *offset,
 GAP_HANDLING gap_handling)
 {
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the arena for the zone tables described in
+   `zone_arena.hpp`. */
+#include "zone_arena.hpp"
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// The size of a huge page on x86-64, and the size of the chunks.
+static const size_t chunk_size = 2 * 1024 * 1024;
+static const size_t alignment = 16;
+
+#if defined(__linux__)
+/* Whether the transparent huge pages can be requested with `madvise`. If
+   they are disabled, `madvise` still succeeds, but has no effect. */
+static bool transparent_huge_pages_enabled()
+{
+    FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char modes[128];
+    bool enabled = fgets(modes, sizeof(modes), file) != nullptr &&
+        strstr(modes, "[never]") == nullptr;
+    fclose(file);
+    return enabled;
+}
+#endif
+
+/* Maps `size` bytes, a positive multiple of `chunk_size`, trying the
+   reserved huge pages first, then the transparent ones. */
+static char *map_chunk(size_t size, bool& huge_pages)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+#if defined(__linux__)
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+        huge_pages = true;
+        return static_cast<char *>(memory);
+    }
+    /* Transparent huge pages are only used for the aligned ranges, so more
+       is mapped, and the unaligned ends are unmapped. */
+    memory = mmap(nullptr, size + chunk_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    char *start = static_cast<char *>(memory);
+    size_t misalignment = reinterpret_cast<uintptr_t>(start) % chunk_size;
+    size_t head = misalignment == 0 ? 0 : chunk_size - misalignment;
+    if (head > 0) {
+        munmap(start, head);
+    }
+    munmap(start + head + size, chunk_size - head);
+    if (madvise(start + head, size, MADV_HUGEPAGE) == 0 &&
+        transparent_huge_pages_enabled())
+    {
+        huge_pages = true;
+    }
+    return start + head;
+#else
+    return static_cast<char *>(malloc(size));
+#endif
+}
+
+bool zone_arena::map_for(size_t bytes)
+{
+    // The rest of the current chunk is wasted, but it's at most a table.
+    size_t size = (bytes + chunk_size - 1) / chunk_size * chunk_size;
+    bool huge = false;
+    char *chunk = map_chunk(size, huge);
+    if (chunk == nullptr) {
+        return false;
+    }
+    huge_pages = huge_pages || huge;
+    if (first == nullptr) {
+        first = chunk;
+    }
+    current = chunk;
+    left = size;
+    return true;
+}
+
+void *zone_arena::allocate(size_t bytes)
+{
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (bytes == 0) {
+        return current;
+    }
+    if ((current == nullptr || bytes > left) && !map_for(bytes)) {
+        throw std::bad_alloc();
+    }
+    void *result = current;
+    current += bytes;
+    left -= bytes;
+    allocated += bytes;
+    return result;
+}
+
+bool zone_arena::reserve()
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return current != nullptr || map_for(chunk_size);
+}
+
+bool zone_arena::uses_huge_pages() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return huge_pages;
+}
+
+const void *zone_arena::first_chunk() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return first;
+}
+
+size_t zone_arena::allocated_bytes() const
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    return allocated;
+}
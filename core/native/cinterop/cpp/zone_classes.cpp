@@ -0,0 +1,128 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the partitioning of zones into classes of zones with
+   the same offsets, declared in `cdate.h`.
+
+   The table of each zone is clipped to the requested range and hashed; only
+   the zones with equal hashes are compared in full. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+/* The offsets of a zone in a range: `offsets[i]` is in effect from
+   `begins[i]`, the first of which is the start of the range. Adjacent offsets
+   are always different. */
+struct clipped_history {
+    std::vector<int64_t> begins;
+    std::vector<int> offsets;
+    uint64_t hash;
+
+    bool operator==(const clipped_history& other) const {
+        return hash == other.hash && begins == other.begins &&
+            offsets == other.offsets;
+    }
+};
+
+static void mix(uint64_t& hash, uint64_t value)
+{
+    // FNV-1a, a byte at a time.
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+static bool clip(TZID zone, int64_t from, int64_t until,
+    clipped_history& history)
+{
+    auto table = compiled_zone(zone);
+    if (table == nullptr) {
+        return false;
+    }
+    history.hash = 14695981039346656037ULL;
+    zone_period period;
+    for (int64_t instant = from; instant < until; instant = period.end) {
+        if (!table->period_at(instant, period)) {
+            return false;
+        }
+        if (history.offsets.empty() || history.offsets.back() != period.offset)
+        {
+            history.begins.push_back(instant);
+            history.offsets.push_back(period.offset);
+            mix(history.hash, (uint64_t)(instant - from));
+            mix(history.hash, (uint64_t)(int64_t)period.offset);
+        }
+        if (period.end <= instant) {
+            break;
+        }
+    }
+    return true;
+}
+
+extern "C" {
+
+bool zone_equivalence_classes(const TZID *zones, size_t zone_count,
+    int64_t from_epoch_sec, int64_t until_epoch_sec,
+    struct zone_classes *result)
+{
+    std::vector<TZID> ids;
+    if (zones == nullptr) {
+        ids = all_zone_ids();
+    } else {
+        ids.assign(zones, zones + zone_count);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    std::vector<clipped_history> histories;
+    std::vector<std::vector<TZID>> classes;
+    std::unordered_multimap<uint64_t, size_t> classes_by_hash;
+    for (auto id : ids) {
+        clipped_history history;
+        if (!clip(id, from_epoch_sec, until_epoch_sec, history)) {
+            return false;
+        }
+        auto range = classes_by_hash.equal_range(history.hash);
+        auto it = range.first;
+        for (; it != range.second; ++it) {
+            if (histories[it->second] == history) {
+                break;
+            }
+        }
+        if (it != range.second) {
+            classes[it->second].push_back(id);
+        } else {
+            classes_by_hash.emplace(history.hash, histories.size());
+            histories.push_back(std::move(history));
+            classes.push_back(std::vector<TZID>(1, id));
+        }
+    }
+    result->zone_count = ids.size();
+    result->class_count = classes.size();
+    result->zones = check_allocation(
+        (TZID *)malloc(sizeof(TZID) * std::max(ids.size(), (size_t)1)));
+    result->class_starts = check_allocation(
+        (size_t *)malloc(sizeof(size_t) * (classes.size() + 1)));
+    size_t position = 0;
+    for (size_t i = 0; i < classes.size(); ++i) {
+        result->class_starts[i] = position;
+        memcpy(result->zones + position, classes[i].data(),
+            sizeof(TZID) * classes[i].size());
+        position += classes[i].size();
+    }
+    result->class_starts[classes.size()] = position;
+    return true;
+}
+
+void zone_classes_free(struct zone_classes *classes)
+{
+    free(classes->zones);
+    free(classes->class_starts);
+    classes->zones = nullptr;
+    classes->class_starts = nullptr;
+}
+
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the queries about the names of zones declared in
+   `cdate.h` on top of the per-name lookup of the platform.
+
+   The search by prefix uses an index that is built on first use: the names
+   of all the zones are stored one after another, and the positions where
+   words start in them are sorted by the text that follows, so the matches
+   of a prefix are a contiguous range found with a binary search. There are
+   two such lists, one for the names as they are and one for their lowercase
+   versions. */
+#include "helper_macros.hpp"
+#include "zone_table.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+// A place in the text of the index where some name or its word starts.
+struct name_suffix {
+    uint32_t start;
+    TZID zone;
+};
+
+struct name_index {
+    // The names, each followed by '\0'.
+    std::string text;
+    std::string lowercase_text;
+    std::vector<name_suffix> suffixes;
+    std::vector<name_suffix> lowercase_suffixes;
+};
+
+static char lowercase(char c)
+{
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// The words are separated like in `America/Port_of_Spain` or `Etc/GMT-1`.
+static bool starts_word(const std::string& text, size_t i)
+{
+    if (i == 0 || text[i - 1] == '\0') {
+        return true;
+    }
+    char previous = text[i - 1];
+    return previous == '/' || previous == '_' || previous == '-';
+}
+
+static void sort_suffixes(const std::string& text,
+    std::vector<name_suffix>& suffixes)
+{
+    const char *data = text.c_str();
+    std::sort(suffixes.begin(), suffixes.end(),
+        [data](const name_suffix& a, const name_suffix& b) {
+            int comparison = strcmp(data + a.start, data + b.start);
+            return comparison != 0 ? comparison < 0 : a.zone < b.zone;
+        });
+}
+
+static name_index build_index()
+{
+    name_index index;
+    for (auto id : all_zone_ids()) {
+        const char *name = timezone_name_by_id(id);
+        if (name == nullptr) {
+            continue;
+        }
+        size_t start = index.text.size();
+        index.text += name;
+        index.text += '\0';
+        for (size_t i = start; i + 1 < index.text.size(); ++i) {
+            if (starts_word(index.text, i)) {
+                index.suffixes.push_back(name_suffix{(uint32_t)i, id});
+            }
+        }
+    }
+    index.lowercase_text = index.text;
+    std::transform(index.text.begin(), index.text.end(),
+        index.lowercase_text.begin(), lowercase);
+    index.lowercase_suffixes = index.suffixes;
+    sort_suffixes(index.text, index.suffixes);
+    sort_suffixes(index.lowercase_text, index.lowercase_suffixes);
+    return index;
+}
+
+static const name_index& index_of_names()
+{
+    // Initialization of local statics is thread-safe.
+    static const name_index index = build_index();
+    return index;
+}
+
+/* Finds the zones with a word starting with `prefix`, which is already
+   lowercase if `text` is. The result is sorted. */
+static std::vector<TZID> zones_with_prefix(const std::string& text,
+    const std::vector<name_suffix>& suffixes, const std::string& prefix)
+{
+    const char *data = text.c_str();
+    size_t length = prefix.size();
+    auto begin = std::lower_bound(suffixes.begin(), suffixes.end(), prefix,
+        [data, length](const name_suffix& suffix, const std::string& prefix) {
+            return strncmp(data + suffix.start, prefix.c_str(), length) < 0;
+        });
+    auto end = std::upper_bound(begin, suffixes.end(), prefix,
+        [data, length](const std::string& prefix, const name_suffix& suffix) {
+            return strncmp(prefix.c_str(), data + suffix.start, length) < 0;
+        });
+    std::vector<TZID> zones;
+    for (auto it = begin; it != end; ++it) {
+        zones.push_back(it->zone);
+    }
+    std::sort(zones.begin(), zones.end());
+    zones.erase(std::unique(zones.begin(), zones.end()), zones.end());
+    return zones;
+}
+
+extern "C" {
+
+void timezones_by_names(const char * const *zone_names, size_t count,
+    TZID *ids)
+{
+    // The same names tend to repeat in a batch, so each is looked up once.
+    std::unordered_map<std::string, TZID> resolved;
+    for (size_t i = 0; i < count; ++i) {
+        auto inserted = resolved.insert(std::make_pair(
+            std::string(zone_names[i]), TZID_INVALID));
+        if (inserted.second) {
+            inserted.first->second = timezone_by_name(zone_names[i]);
+        }
+        ids[i] = inserted.first->second;
+    }
+}
+
+TZID * zones_with_name_prefix(const char *prefix, bool ignore_case,
+    size_t *count)
+{
+    auto& index = index_of_names();
+    std::string query(prefix);
+    std::vector<TZID> result;
+    if (ignore_case) {
+        std::transform(query.begin(), query.end(), query.begin(), lowercase);
+        result = zones_with_prefix(index.lowercase_text,
+            index.lowercase_suffixes, query);
+    } else {
+        result = zones_with_prefix(index.text, index.suffixes, query);
+    }
+    TZID *array = check_allocation(
+        (TZID *)malloc(sizeof(TZID) * std::max(result.size(), (size_t)1)));
+    if (!result.empty()) {
+        memcpy(array, result.data(), sizeof(TZID) * result.size());
+    }
+    *count = result.size();
+    return array;
+}
+
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file implements the time zone tables described in `zone_table.hpp`.
+   It only relies on `zone_period_at`, so it is shared by all platforms. */
+#include "zone_table.hpp"
+#include "numa.hpp"
+#include "published_tables.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+// The offsets of real time zones never differ from UTC by a day or more.
+static const int64_t max_offset_magnitude = 24 * 60 * 60;
+
+bool zone_table::load(TZID zone)
+{
+    id = zone;
+    begins.clear();
+    offsets.clear();
+    zone_period period;
+    if (!zone_period_at(zone, INT64_MIN, period)) {
+        return false;
+    }
+    // Collected separately so that the table only takes as much as it needs.
+    std::vector<int64_t> loaded_begins;
+    std::vector<int> loaded_offsets;
+    period.begin = INT64_MIN;
+    while (true) {
+        // Adjacent periods can differ in something other than the offset.
+        if (loaded_offsets.empty() || loaded_offsets.back() != period.offset) {
+            loaded_begins.push_back(period.begin);
+            loaded_offsets.push_back(period.offset);
+        }
+        tail_end = period.end;
+        if (period.end >= compiled_until || period.end <= period.begin) {
+            break;
+        }
+        if (!zone_period_at(zone, period.end, period)) {
+            return false;
+        }
+    }
+    begins.assign(loaded_begins.begin(), loaded_begins.end());
+    offsets.assign(loaded_offsets.begin(), loaded_offsets.end());
+    index_local_times();
+    return true;
+}
+
+void zone_table::load_fixed(int offset)
+{
+    id = TZID_INVALID;
+    begins.assign(1, INT64_MIN);
+    offsets.assign(1, offset);
+    tail_end = INT64_MAX;
+    index_local_times();
+}
+
+void zone_table::load_periods(std::vector<int64_t> begins,
+    std::vector<int> offsets)
+{
+    id = TZID_INVALID;
+    this->begins.assign(begins.begin(), begins.end());
+    this->offsets.assign(offsets.begin(), offsets.end());
+    tail_end = INT64_MAX;
+    index_local_times();
+}
+
+void zone_table::use_arena(zone_arena *arena)
+{
+    begins = decltype(begins)(arena_allocator<int64_t>(arena));
+    offsets = decltype(offsets)(arena_allocator<int>(arena));
+    local_begins = decltype(local_begins)(arena_allocator<int64_t>(arena));
+}
+
+void zone_table::index_local_times()
+{
+    std::vector<int64_t> starts;
+    local_begins.clear();
+    local_end = INT64_MIN;
+    for (size_t i = 0; i < begins.size(); ++i) {
+        bool last = i + 1 == begins.size();
+        /* The local date-times of the period that are not in a gap or an
+           overlap with the neighboring periods. */
+        int64_t unique_begin = i == 0 ? INT64_MIN :
+            begins[i] + std::max(offsets[i - 1], offsets[i]);
+        int64_t unique_end = last ? INT64_MAX :
+            begins[i + 1] + std::min(offsets[i], offsets[i + 1]);
+        if (unique_begin > unique_end) {
+            // The period is shorter than the transitions around it.
+            return;
+        }
+        starts.push_back(unique_begin);
+        if (!last) {
+            // Empty if the offset doesn't change.
+            starts.push_back(unique_end);
+        }
+    }
+    local_begins.assign(starts.begin(), starts.end());
+    /* The instants corresponding to the later local date-times may be after
+       the stored periods. */
+    local_end = tail_end == INT64_MAX ? INT64_MAX :
+        tail_end - max_offset_magnitude;
+}
+
+void zone_table::resolve_local_interval(size_t j,
+    local_resolution& result) const
+{
+    size_t i = j / 2;
+    result.first = period(i);
+    if (j % 2 == 0) {
+        result.kind = LOCAL_UNIQUE;
+    } else {
+        result.second = period(i + 1);
+        result.kind = result.second.offset > result.first.offset ?
+            LOCAL_GAP : LOCAL_OVERLAP;
+    }
+}
+
+bool zone_table::period_at(int64_t epoch_sec, zone_period& period) const
+{
+    if (epoch_sec >= tail_end) {
+        return zone_period_at(id, epoch_sec, period);
+    }
+    size_t i = std::upper_bound(begins.begin(), begins.end(), epoch_sec)
+        - begins.begin() - 1;
+    period = this->period(i);
+    return true;
+}
+
+zone_period zone_table::period(size_t i) const
+{
+    zone_period period;
+    period.begin = begins[i];
+    period.end = i + 1 < begins.size() ? begins[i + 1] : tail_end;
+    period.offset = offsets[i];
+    return period;
+}
+
+bool zone_table::resolve_local(int64_t local_sec, local_resolution& result)
+    const
+{
+    if (local_sec < local_end) {
+        /* Of the intervals starting at the same local second, all but the
+           last are empty, and the last one is found. */
+        size_t j = std::upper_bound(local_begins.begin(), local_begins.end(),
+            local_sec) - local_begins.begin() - 1;
+        resolve_local_interval(j, result);
+        return true;
+    }
+    /* Only the periods intersecting [local - max offset; local + max offset)
+       may contain the corresponding instant, so they are all checked in
+       order. */
+    zone_period period, previous;
+    int found = 0;
+    bool has_previous = false;
+    int64_t window_start = local_sec > INT64_MIN + max_offset_magnitude ?
+        local_sec - max_offset_magnitude : INT64_MIN;
+    int64_t window_end = local_sec < INT64_MAX - max_offset_magnitude ?
+        local_sec + max_offset_magnitude : INT64_MAX;
+    if (!period_at(window_start, period)) {
+        return false;
+    }
+    while (true) {
+        int64_t instant = local_sec - period.offset;
+        if (instant >= period.begin && instant < period.end) {
+            (found == 0 ? result.first : result.second) = period;
+            ++found;
+        } else if (found == 0 && has_previous && instant < period.begin) {
+            // `local_sec` is after the end of `previous`, but before `period`.
+            result.kind = LOCAL_GAP;
+            result.first = previous;
+            result.second = period;
+            return true;
+        }
+        if (period.end >= window_end || found == 2) {
+            break;
+        }
+        previous = period;
+        has_previous = true;
+        if (!period_at(period.end, period)) {
+            return false;
+        }
+    }
+    if (found == 0) {
+        // Only possible if the offset is not within the expected bounds.
+        return false;
+    }
+    result.kind = found == 1 ? LOCAL_UNIQUE : LOCAL_OVERLAP;
+    return true;
+}
+
+bool zone_table::resolve_local_from(int64_t local_sec, size_t& cursor,
+    local_resolution& result) const
+{
+    if (local_sec >= local_end) {
+        return resolve_local(local_sec, result);
+    }
+    if (cursor >= local_begins.size() || local_sec < local_begins[cursor]) {
+        // Not in increasing order, so the search starts over.
+        cursor = std::upper_bound(local_begins.begin(), local_begins.end(),
+            local_sec) - local_begins.begin() - 1;
+    } else {
+        while (cursor + 1 < local_begins.size() &&
+            local_begins[cursor + 1] <= local_sec)
+        {
+            ++cursor;
+        }
+    }
+    resolve_local_interval(cursor, result);
+    return true;
+}
+
+int zone_table::max_offset_after(int64_t epoch_sec) const
+{
+    size_t i = std::upper_bound(begins.begin(), begins.end(), epoch_sec)
+        - begins.begin() - 1;
+    return *std::max_element(offsets.begin() + i, offsets.end());
+}
+
+static published_tables<zone_table> tables;
+
+/* The copies of the tables for each NUMA node. A copy is made by the first
+   thread that needs it on that node, so, as memory is usually allocated on
+   the node that first touches it, the copy ends up in the local memory. */
+static const size_t max_replicated_nodes = 16;
+static published_tables<zone_table> replicas[max_replicated_nodes];
+static std::atomic<bool> replicate(false);
+
+/* If set, the tables are packed into the arena of the node where they are
+   built instead of being spread over the heap. */
+static std::atomic<bool> use_arenas(false);
+static zone_arena arenas[max_replicated_nodes];
+
+static zone_arena *arena_for_current_node()
+{
+    if (!use_arenas.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    size_t node = current_numa_node();
+    return &arenas[node < max_replicated_nodes ? node : 0];
+}
+
+const zone_table *compiled_zone(TZID zone)
+{
+    auto table = tables.get(zone, [zone](zone_table& table) {
+        table.use_arena(arena_for_current_node());
+        return table.load(zone);
+    });
+    if (table == nullptr || !replicate.load(std::memory_order_relaxed)) {
+        return table;
+    }
+    size_t node = current_numa_node();
+    if (node >= max_replicated_nodes) {
+        return table;
+    }
+    return replicas[node].get(zone, [table](zone_table& replica) {
+        replica.use_arena(arena_for_current_node());
+        replica = *table;
+        return true;
+    });
+}
+
+extern "C" {
+
+int offset_at_instant_with_validity(TZID zone, int64_t epoch_sec,
+    int64_t *valid_from, int64_t *valid_until)
+{
+    zone_period period;
+    if (!zone_period_at(zone, epoch_sec, period)) {
+        return INT_MAX;
+    }
+    *valid_from = period.begin;
+    *valid_until = period.end;
+    return period.offset;
+}
+
+bool zone_tables_replicate_per_node(bool enable)
+{
+    bool effective = enable && numa_node_count() > 1;
+    replicate.store(effective, std::memory_order_relaxed);
+    return effective;
+}
+
+bool zone_tables_use_huge_pages(bool enable)
+{
+    use_arenas.store(enable, std::memory_order_relaxed);
+    if (!enable) {
+        return false;
+    }
+    // Map the first chunk right away to find out whether it worked.
+    zone_arena *arena = arena_for_current_node();
+    return arena->reserve() && arena->uses_huge_pages();
+}
+
+bool zone_tables_arena(const void **first_chunk, size_t *allocated)
+{
+    zone_arena *arena = arena_for_current_node();
+    if (arena == nullptr) {
+        return false;
+    }
+    *first_chunk = arena->first_chunk();
+    *allocated = arena->allocated_bytes();
+    return true;
+}
+
+}
@@ -11,9 +11,20 @@
 typedef size_t TZID;
 const TZID TZID_INVALID = SIZE_MAX;
 
+typedef size_t TZDB_VERSION;
+const TZDB_VERSION TZDB_VERSION_INVALID = SIZE_MAX;
+
 enum GAP_HANDLING {
     GAP_HANDLING_MOVE_FORWARD,
     GAP_HANDLING_NEXT_CORRECT,
+    // Only supported by the functions that process many date-times at once.
+    GAP_HANDLING_SKIP,
+};
+
+enum OVERLAP_HANDLING {
+    OVERLAP_HANDLING_EARLIER,
+    OVERLAP_HANDLING_LATER,
+    OVERLAP_HANDLING_BOTH,
 };
 
 // Returns true if successful.
@@ -31,9 +42,36 @@ char ** available_zone_ids();
 // returns the offset, or INT_MAX if there's a problem with the time zone.
 int offset_at_instant(TZID zone, int64_t epoch_sec);
 
+/* The same as `offset_at_instant`, but also stores the interval
+   [valid_from; valid_until) of UTC seconds around the instant during which
+   the offset is the same, as reported by the platform, so that the offset can
+   be reused for the other instants in it. The offset may stay the same
+   outside of the interval, too, if the platform reports a change in
+   something else, like the abbreviation. The interval is only stored if the
+   offset is found. */
+int offset_at_instant_with_validity(TZID zone, int64_t epoch_sec,
+    int64_t *valid_from, int64_t *valid_until);
+
 // returns the id of the timezone or TZID_INVALID in case of an error.
 TZID timezone_by_name(const char *zone_name);
 
+/* Looks up `count` timezones by their names at once, storing the id of each,
+   or TZID_INVALID if there's no such timezone, to `ids`. */
+void timezones_by_names(const char * const *zone_names, size_t count,
+    TZID *ids);
+
+/* Returns an array of the ids of the zones whose names have a word starting
+   with `prefix`, storing its length in `count`. The words start at the
+   beginning of the name and after each '/', '_', or '-', so both "new_y" and
+   "york" find `America/New_York` if `ignore_case` is set. The array is sorted
+   and must be freed by the caller. The names are indexed on the first call. */
+TZID * zones_with_name_prefix(const char *prefix, bool ignore_case,
+    size_t *count);
+
+/* Returns the name of the timezone, which must not be freed, as it lives
+   until the end of the process, or NULL in case of an error. */
+const char * timezone_name_by_id(TZID zone);
+
 /* Sets the result in "offset"; in case an existing value in "offset" is an
    acceptable one, leaves it untouched. Returns the number of seconds that the
    caller needs to add to their existing estimation of date, which is needed in
@@ -42,3 +80,357 @@ TZID timezone_by_name(const char *zone_name);
 int offset_at_datetime(TZID zone, int64_t epoch_sec, int *offset);
 
 int64_t at_start_of_day(TZID zone, int64_t midnight_epoch_sec);
+
+enum RECURRENCE_FREQUENCY {
+    RECURRENCE_DAILY,
+    RECURRENCE_WEEKLY,
+    RECURRENCE_MONTHLY,
+};
+
+struct recurrence_rule {
+    enum RECURRENCE_FREQUENCY frequency;
+    /* The rule applies every `interval` days, weeks, or months, counting from
+       the one containing `start_epoch_day`, the first date that can have an
+       occurrence. */
+    int interval;
+    int64_t start_epoch_day;
+    // The local time of the occurrences.
+    int second_of_day;
+    // For weekly rules: bit 0 is set for Monday, ..., bit 6 for Sunday.
+    int days_of_week;
+    /* For monthly rules: the day of the month, or, if negative, the day
+       counting from the end of the month, -1 being the last one. Months that
+       don't have such a day are skipped. */
+    int day_of_month;
+};
+
+/* The greatest number of the days with occurrences in the range passed to
+   `expand_recurrence`. */
+const size_t RECURRENCE_MAX_DAYS = 10000000;
+
+/* Returns a sorted array of the distinct instants in [from; until) that
+   correspond to the occurrences of the rule in the given zone, storing its
+   length in `count`. The array must be freed by the caller. Only the
+   occurrences in the years -32767 to 32767 are computed.
+   In case the zone or the rule is invalid, including the rules starting
+   outside of these years, or the range has more than `RECURRENCE_MAX_DAYS`
+   days with occurrences, NULL is returned. */
+int64_t * expand_recurrence(TZID zone, const struct recurrence_rule *rule,
+    int64_t from_epoch_sec, int64_t until_epoch_sec,
+    enum GAP_HANDLING gap_handling, enum OVERLAP_HANDLING overlap_handling,
+    size_t *count);
+
+// The same as `expand_recurrence`, but for a constant offset.
+int64_t * expand_recurrence_at_offset(int offset,
+    const struct recurrence_rule *rule,
+    int64_t from_epoch_sec, int64_t until_epoch_sec, size_t *count);
+
+/* A hierarchical timer wheel for timers set to local date-times in time
+   zones. The wheel is not thread-safe. */
+struct timer_wheel;
+
+// Returns a new wheel, whose current time is `now_epoch_sec`.
+struct timer_wheel * timer_wheel_create(int64_t now_epoch_sec);
+
+void timer_wheel_destroy(struct timer_wheel *wheel);
+
+/* Schedules a timer to fire at the given local date-time in the zone. If the
+   date-time is in a gap, the timer fires at the end of the gap; if it is in
+   an overlap, at the earlier of the two instants. If `repeat_days` is
+   positive, the timer is scheduled again at the same local time this many
+   days later each time it fires.
+   Returns a non-negative id of the timer, or -1 if the zone is invalid. */
+int64_t timer_wheel_schedule(struct timer_wheel *wheel, TZID zone,
+    int64_t local_epoch_sec, int repeat_days, uint64_t payload);
+
+// The same as `timer_wheel_schedule`, but for a constant offset.
+int64_t timer_wheel_schedule_at_offset(struct timer_wheel *wheel, int offset,
+    int64_t local_epoch_sec, int repeat_days, uint64_t payload);
+
+// Returns true if the timer was scheduled and didn't fire yet.
+bool timer_wheel_cancel(struct timer_wheel *wheel, int64_t timer_id);
+
+/* Moves the current time of the wheel forward to `now_epoch_sec` and stores
+   the payloads of the timers that fired in `fired`, in the order of their
+   firing, at most `capacity` of them. Returns the number of stored payloads;
+   if it's `capacity`, there may be more, and the function should be called
+   again. */
+size_t timer_wheel_advance(struct timer_wheel *wheel, int64_t now_epoch_sec,
+    uint64_t *fired, size_t capacity);
+
+// Returns the number of timers that are scheduled and didn't fire yet.
+size_t timer_wheel_size(const struct timer_wheel *wheel);
+
+/* Returns an array of the ids of the zones where the offset was `offset` at
+   some moment in [from; until), storing its length in `count`. The array is
+   sorted and must be freed by the caller. The answers are computed with an
+   index that is built on the first call.
+   In case of an error, NULL is returned. */
+TZID * zones_with_offset(int offset, int64_t from_epoch_sec,
+    int64_t until_epoch_sec, size_t *count);
+
+/* Finds the zones consistent with each of `history_count` histories of
+   observed offsets. The observations of the history `i` are those with
+   indices in [history_starts[i]; history_starts[i + 1]), each stating that
+   the offset at `instants[j]` was `offsets[j]`.
+   Returns an array of the ids of the zones where the offsets were exactly as
+   observed, sorted for each history, one history after another. The zones of
+   the history `i` start at the index `zone_starts[i]`, and
+   `zone_starts[history_count]` is the length of the array.
+   `history_starts` and `zone_starts` have `history_count + 1` elements.
+   The returned array must be freed by the caller. */
+TZID * infer_zones(const int64_t *instants, const int *offsets,
+    const size_t *history_starts, size_t history_count, size_t *zone_starts);
+
+/* Zones grouped into classes: the zones of the class `i` are those in
+   `zones` with indices in [class_starts[i]; class_starts[i + 1]). */
+struct zone_classes {
+    TZID *zones;
+    size_t *class_starts;
+    size_t zone_count;
+    size_t class_count;
+};
+
+/* Partitions zones into classes of zones whose offsets are the same at each
+   moment in [from; until), so that anything computed from the offsets in that
+   range can be shared in a class. If `zones` is NULL, all the zones are
+   partitioned; otherwise, the `zone_count` zones in it. The zones in each
+   class are sorted, and the classes are ordered by their first zones.
+   Returns false if some zone is invalid. Otherwise, the result must be freed
+   with `zone_classes_free`. */
+bool zone_equivalence_classes(const TZID *zones, size_t zone_count,
+    int64_t from_epoch_sec, int64_t until_epoch_sec,
+    struct zone_classes *result);
+
+void zone_classes_free(struct zone_classes *classes);
+
+/* Loads a version of the time zone database from a directory of TZif files,
+   like a copy of `/usr/share/zoneinfo` made while the version was current.
+   The zones that are the same as in the versions loaded earlier share the
+   memory with them. Versions are never unloaded.
+   The ids of the zones of a version are only meaningful for the functions
+   below, together with the version, and go from 0 to the number of zones. The
+   recurring rules of the zones are only followed until the year 2200.
+   Returns TZDB_VERSION_INVALID if no zones were found in the directory or too
+   many versions are loaded. */
+TZDB_VERSION tzdb_version_load(const char *directory);
+
+// Returns the number of zones in the version, or 0 if it is not loaded.
+size_t tzdb_version_zone_count(TZDB_VERSION version);
+
+// Returns the id of the zone in the version, or TZID_INVALID.
+TZID tzdb_version_zone_by_name(TZDB_VERSION version, const char *zone_name);
+
+/* Returns the name of the zone in the version, which must not be freed, or
+   NULL in case of an error. */
+const char * tzdb_version_zone_name(TZDB_VERSION version, TZID zone);
+
+// The same as `offset_at_instant`, but for a zone of the version.
+int tzdb_version_offset_at_instant(TZDB_VERSION version, TZID zone,
+    int64_t epoch_sec);
+
+// The same as `offset_at_datetime`, but for a zone of the version.
+int tzdb_version_offset_at_datetime(TZDB_VERSION version, TZID zone,
+    int64_t epoch_sec, int *offset);
+
+/* The same as `at_start_of_day`, but for a zone of the version. Returns
+   INT64_MAX in case of an error. */
+int64_t tzdb_version_at_start_of_day(TZDB_VERSION version, TZID zone,
+    int64_t midnight_epoch_sec);
+
+/* A range of instants [begin; end) where the offsets of a zone differ between
+   two versions of the time zone database. The zone is identified by its id in
+   each version, one of which is TZID_INVALID if the zone is missing from that
+   version. */
+struct tzdb_difference {
+    TZID old_zone;
+    TZID new_zone;
+    int64_t begin;
+    int64_t end;
+};
+
+/* Returns an array of the maximal ranges in [from; until) where the offsets of
+   the zones with the same names differ between the two versions, storing its
+   length in `count`. The ranges are ordered by the names of their zones, then
+   by time. The array must be freed by the caller.
+   Returns NULL if one of the versions is not loaded. */
+struct tzdb_difference * tzdb_version_diff(TZDB_VERSION old_version,
+    TZDB_VERSION new_version, int64_t from_epoch_sec, int64_t until_epoch_sec,
+    size_t *count);
+
+/* Loads the table of leap seconds from a TZif file with leap second records,
+   like `/usr/share/zoneinfo/right/UTC`, or from a file in the format of the
+   `leapseconds` file of the time zone database, replacing the table loaded
+   before. If no table is loaded, the system one is loaded on first use, where
+   available. Returns false if the file could not be read. */
+bool leap_seconds_load(const char *path);
+
+/* Converts `count` UTC instants, in seconds since the epoch not counting the
+   leap seconds, to TAI seconds, that is, the same instants plus TAI - UTC,
+   like the readings of `CLOCK_TAI`. The offset of 10 seconds that was in
+   effect in 1972 is used for the earlier instants.
+   Returns false if no table of leap seconds is available. */
+bool utc_to_tai(const int64_t *utc_epoch_sec, int64_t *tai_sec, size_t count);
+
+/* The reverse of `utc_to_tai`. The inserted leap seconds are mapped to the
+   UTC second that follows them. */
+bool tai_to_utc(const int64_t *tai_sec, int64_t *utc_epoch_sec, size_t count);
+
+/* Reads the current time in TAI seconds. The system TAI clock is used if the
+   system knows its offset from UTC; otherwise, the UTC reading is converted
+   with the table of leap seconds. Returns true if successful. */
+bool current_time_tai(int64_t *sec, int32_t *nano);
+
+/* Returns the abbreviation of the zone at the instant, like `CEST`, or NULL
+   in case of an error. The string must not be freed, as it lives until the
+   end of the process, and equal abbreviations are the same pointer.
+   Where the platform doesn't provide abbreviations, the offset is written
+   instead, like `+0530`. */
+const char * abbreviation_at_instant(TZID zone, int64_t epoch_sec);
+
+/* Returns an array of the ids of the zones that used the abbreviation at some
+   moment in [from; until), storing its length in `count`. The array is sorted
+   and must be freed by the caller. The answers are computed with an index that
+   is built on the first call. */
+TZID * zones_with_abbreviation(const char *abbreviation,
+    int64_t from_epoch_sec, int64_t until_epoch_sec, size_t *count);
+
+/* Makes the tables of the zones, which are computed on the first use by most
+   of the queries that look at many instants, be copied to each NUMA node, so
+   that the threads on different nodes read them from their local memory.
+   This costs a copy of the tables per node. Returns whether the tables are
+   replicated, which is never the case on machines with a single node. */
+bool zone_tables_replicate_per_node(bool enable);
+
+/* Makes the tables of the zones that are computed after this be packed
+   together in memory backed by huge pages, so that looking up random zones
+   causes fewer TLB misses. Reserved huge pages are used if there are any;
+   otherwise, transparent huge pages are requested. Should be called before
+   the tables are used, as the tables that are already computed stay where
+   they are. Returns whether huge pages could be used; if not, the tables are
+   still packed together, in ordinary memory. */
+bool zone_tables_use_huge_pages(bool enable);
+
+/* Reports the memory where the tables computed on the NUMA node of the
+   calling thread are packed after `zone_tables_use_huge_pages(true)`:
+   `*first_chunk` is set to the start of the first chunk mapped for them, or
+   to `NULL` if there's none yet, and `*allocated` to the number of bytes the
+   tables take. Returns false if the tables are not packed. */
+bool zone_tables_arena(const void **first_chunk, size_t *allocated);
+
+/* A calendar that tells which days are working days. The days are counted
+   from 1970-01-01. The calendar may be queried from several threads at once,
+   but not while it's being modified. */
+struct business_calendar;
+
+/* Returns a new calendar where the working days are the days of the week in
+   `working_weekdays`, where bit 0 means Monday, ..., and bit 6 means Sunday. */
+struct business_calendar * business_calendar_create(int working_weekdays);
+
+void business_calendar_destroy(struct business_calendar *calendar);
+
+/* Makes the given days working days if `working` is true, or days off, like
+   holidays, otherwise, regardless of their days of the week. */
+void business_calendar_set_days(struct business_calendar *calendar,
+    const int32_t *epoch_days, size_t count, bool working);
+
+bool business_calendar_is_working_day(const struct business_calendar *calendar,
+    int32_t epoch_day);
+
+/* Returns the first working day not before the given day, or INT32_MAX if
+   there's none. */
+int32_t business_calendar_next_working_day(
+    const struct business_calendar *calendar, int32_t epoch_day);
+
+/* For each `i`, stores to `results[i]` the day that is `working_days[i]`
+   working days after `epoch_days[i]`, or before it if negative, or INT32_MAX
+   if there's no such day. The given day itself is not counted, and need not
+   be a working day; if `working_days[i]` is 0, it is returned as is. */
+void business_calendar_add_working_days(
+    const struct business_calendar *calendar, const int32_t *epoch_days,
+    const int32_t *working_days, int32_t *results, size_t count);
+
+/* For each `i`, stores to `results[i]` the number of working days in
+   [from_epoch_days[i]; until_epoch_days[i]), or minus the number of those in
+   [until_epoch_days[i]; from_epoch_days[i]) if `until` is earlier. */
+void business_calendar_count_working_days(
+    const struct business_calendar *calendar, const int32_t *from_epoch_days,
+    const int32_t *until_epoch_days, int32_t *results, size_t count);
+
+/* The columns of a calendar dimension table, which has a row for each day of
+   a range. Each column is an array with an element per row, or NULL if it is
+   not needed. The columns that depend on the zone have the rows for each zone
+   one after another, so the row `i` of the zone `z` is at `z * days + i`. */
+struct calendar_columns {
+    int32_t *epoch_days;
+    int32_t *years;
+    int32_t *months;
+    int32_t *days_of_month;
+    // From 1 for Monday to 7 for Sunday.
+    int32_t *days_of_week;
+    int32_t *days_of_year;
+    // The ISO 8601 week-based year and the week in it.
+    int32_t *week_based_years;
+    int32_t *weeks;
+    int32_t *quarters;
+    /* The first instant of the day in the zone, like `at_start_of_day`: if
+       midnight happens twice, the earlier one, and if it is skipped, the end
+       of the gap. */
+    int64_t *starts_of_day;
+    /* Whether the offset at the start of the day is greater than the smaller
+       of the offsets at the beginnings of January 1 and July 1 of that year
+       in UTC, which is taken for the standard one. */
+    bool *daylight_saving;
+};
+
+/* Fills the columns for the days in [from; until) and the `zone_count` zones
+   in `zones`. The start of each day in a zone is found by moving through the
+   transitions of the zone along with the days, without a separate lookup for
+   each day. Returns false if some zone is invalid. */
+bool calendar_columns_fill(int32_t from_epoch_day, int32_t until_epoch_day,
+    const TZID *zones, size_t zone_count, struct calendar_columns *columns);
+
+/* Returns the number of seconds from the current second until the next
+   moment, possibly the current one, when the local time in the zone is
+   `second_of_day`, or INT64_MAX in case of an error. If the time is skipped
+   by a transition, it is moved forward by the length of the gap, as with
+   `GAP_HANDLING_MOVE_FORWARD`; if it happens twice, the earlier occurrence
+   is taken unless it's already in the past. */
+int64_t seconds_until_local_time(TZID zone, int32_t second_of_day);
+
+/* For each `i`, stores to `results[i]` the number of seconds from
+   `now_epoch_sec` until the next moment when the local time in `zones[i]` is
+   `seconds_of_day[i]`, like `seconds_until_local_time` does for the current
+   time, or INT64_MAX if the zone or the time is invalid. Returns false if
+   this happened for some `i`. */
+bool seconds_until_local_times(const TZID *zones,
+    const int32_t *seconds_of_day, size_t count, int64_t now_epoch_sec,
+    int64_t *results);
+
+/* For each `i`, finds how `local_epoch_secs[i]`, the number of seconds since
+   1970-01-01T00:00 of a local date-time in the zone, maps to UTC, storing to
+   `offsets_before[i]` and `offsets_after[i]` the offsets in effect before and
+   after the transition that creates a gap or an overlap around the
+   date-time. So the date-time is skipped if the offset after is greater,
+   happens twice, at these offsets, if it is less, and happens once, at the
+   only offset stored to both, if they are the same. The transitions of the
+   zone are passed through once if the date-times are in increasing order,
+   but they may come in any order. Returns false if the zone is invalid. */
+bool classify_local_datetimes(TZID zone, const int64_t *local_epoch_secs,
+    size_t count, int32_t *offsets_before, int32_t *offsets_after);
+
+/* Starts a thread that reads the current time every `tick_microseconds` and
+   publishes it for `coarse_clock_epoch_nanos`, or, if it's already running,
+   changes how often it does that. Returns false if `tick_microseconds` is not
+   positive, the thread could not be started, or the current time could not
+   be read. */
+bool coarse_clock_start(int32_t tick_microseconds);
+
+// Stops the thread started by `coarse_clock_start`, if it is running.
+void coarse_clock_stop();
+
+/* Returns the number of nanoseconds since the epoch published last by the
+   thread started by `coarse_clock_start`, which lags behind the current time
+   by up to a tick, or INT64_MIN if the thread is not running. This is a
+   single atomic load that never blocks. */
+int64_t coarse_clock_epoch_nanos();
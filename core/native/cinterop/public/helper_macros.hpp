@@ -4,6 +4,7 @@
  */
 #pragma once
 #include <cstdlib>
+#include <cstdio>
 
 /* Check the given pointer to see if it's null. If so, fail, printing to
    stderr that insufficient memory is available. */
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file describes the NUMA topology of the machine as far as the zone
+   tables need to know it. On Linux, it is read from `/sys/devices/system/node`
+   without relying on libnuma; elsewhere, the machine is assumed to consist of
+   a single node. */
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+// The number of NUMA nodes, at least 1. Nodes are numbered from 0.
+size_t numa_node_count();
+
+/* The node of the CPU the calling thread is running on at the moment. The
+   thread can be moved to another node right after that, so this is only a
+   hint. */
+size_t current_numa_node();
+
+// The CPUs of the given node, or an empty list if it has none.
+std::vector<int> numa_node_cpus(size_t node);
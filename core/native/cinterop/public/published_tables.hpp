@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file describes the cache of the per-zone tables that are computed on
+   the first access and never change afterwards.
+
+   Once a table is built, it is published with a single atomic store of a
+   pointer to it, so finding it later takes two atomic loads and no locking.
+   Threads that need a table that is not built yet all build it, and the
+   first one to finish publishes its copy, while the others discard theirs.
+   This is cheaper than making them wait for each other, as building a table
+   is only done once per zone and doesn't take long. */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+extern "C" {
+#include "cdate.h"
+}
+
+template <class T>
+class published_tables {
+public:
+    published_tables() {
+        for (auto& chunk : chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    published_tables(const published_tables&) = delete;
+    published_tables& operator=(const published_tables&) = delete;
+
+    /* Returns the table for `zone`, building it with `build`, which fills a
+       `T` and returns false if the zone is invalid, on the first access.
+       The table lives until the end of the process. Returns `nullptr` if the
+       zone is invalid; this is not cached. */
+    template <class Build>
+    const T *get(TZID zone, Build build) {
+        if (zone >= chunk_size * max_chunks) {
+            return get_unusual(zone, build);
+        }
+        auto& slot = slot_of(zone);
+        const T *table = slot.load(std::memory_order_acquire);
+        if (table != nullptr) {
+            return table;
+        }
+        std::unique_ptr<T> built(new T());
+        if (!build(*built)) {
+            return nullptr;
+        }
+        if (slot.compare_exchange_strong(table, built.get(),
+            std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return built.release();
+        }
+        // Another thread was faster; `table` is now its copy.
+        return table;
+    }
+
+private:
+    /* The ids of the zones are small, as they are indices in the list of the
+       zones, so the slots are allocated in chunks as they are needed. */
+    static const size_t chunk_size = 256;
+    static const size_t max_chunks = 1024;
+
+    struct chunk {
+        std::atomic<const T *> slots[chunk_size];
+
+        chunk() {
+            for (auto& slot : slots) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::atomic<chunk *> chunks[max_chunks];
+    // Guards `unusual`.
+    std::mutex unusual_mutex;
+    // The tables for the ids that don't fit into the chunks.
+    std::unordered_map<TZID, std::unique_ptr<T>> unusual;
+
+    std::atomic<const T *>& slot_of(TZID zone) {
+        auto& chunk_pointer = chunks[zone / chunk_size];
+        chunk *current = chunk_pointer.load(std::memory_order_acquire);
+        if (current == nullptr) {
+            std::unique_ptr<chunk> allocated(new chunk());
+            if (chunk_pointer.compare_exchange_strong(current, allocated.get(),
+                std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                current = allocated.release();
+            }
+        }
+        return current->slots[zone % chunk_size];
+    }
+
+    template <class Build>
+    const T *get_unusual(TZID zone, Build build) {
+        const std::lock_guard<std::mutex> lock(unusual_mutex);
+        auto& table = unusual[zone];
+        if (!table) {
+            std::unique_ptr<T> built(new T());
+            if (!build(*built)) {
+                unusual.erase(zone);
+                return nullptr;
+            }
+            table = std::move(built);
+        }
+        return table.get();
+    }
+};
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file declares a reader of time zone information files (TZif, described
+   in RFC 8536), which is used to load time zone databases other than the one
+   the platform provides. */
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+struct tzif_leap_second {
+    // The UTC instant at which the correction changes.
+    int64_t occurrence;
+    // The total number of leap seconds from then on.
+    int correction;
+};
+
+struct tzif_data {
+    /* The offset is `offsets[i]` starting from `begins[i]`, the first of which
+       is INT64_MIN. The recurring rules from the footer of the file are
+       expanded until `compiled_until`. Adjacent offsets are different. */
+    std::vector<int64_t> begins;
+    std::vector<int> offsets;
+    std::vector<tzif_leap_second> leap_seconds;
+};
+
+/* Reads the file at `path`. Returns false if it can't be read or is not a
+   valid TZif file. */
+bool read_tzif(const char *path, tzif_data& data);
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file describes the memory where the cached zone tables can be placed
+   so that they are packed together, in huge pages where the system allows
+   it. Looking up random zones then touches few pages and causes few misses
+   in the TLB. */
+#pragma once
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* Memory that is allocated in large chunks and never freed. The chunks are
+   mapped with `MAP_HUGETLB` if the system has huge pages reserved, or are
+   advised to be backed by transparent huge pages otherwise. Where neither is
+   available, they are ordinary memory. */
+class zone_arena {
+public:
+    zone_arena() : first(nullptr), current(nullptr), left(0), allocated(0),
+        huge_pages(false) {}
+    zone_arena(const zone_arena&) = delete;
+    zone_arena& operator=(const zone_arena&) = delete;
+
+    /* Returns memory aligned to 16 bytes. Thread-safe. For 0 bytes, nothing
+       is mapped, and the result, possibly `nullptr`, is not to be accessed. */
+    void *allocate(size_t bytes);
+
+    /* Maps the first chunk if nothing is mapped yet, so that
+       `uses_huge_pages` tells how the memory is backed. Returns false if the
+       memory could not be mapped. */
+    bool reserve();
+
+    // Whether some of the chunks are backed by huge pages, if known.
+    bool uses_huge_pages() const;
+
+    // The first chunk, or `nullptr` if nothing is mapped yet.
+    const void *first_chunk() const;
+
+    // The number of bytes allocated from all the chunks.
+    size_t allocated_bytes() const;
+
+private:
+    // Maps a new chunk for at least `bytes` bytes. Called with `mutex` held.
+    bool map_for(size_t bytes);
+
+    mutable std::mutex mutex;
+    char *first;
+    char *current;
+    size_t left;
+    size_t allocated;
+    bool huge_pages;
+};
+
+/* Allocates from a `zone_arena`, or from the heap if the arena is `nullptr`.
+   The memory of the arena is never freed, so this is only suitable for the
+   containers that are filled once. */
+template <class T>
+class arena_allocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    arena_allocator(zone_arena *arena = nullptr) : arena(arena) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        if (arena == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T *>(arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (arena == nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    zone_arena *arena;
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+    return a.arena == b.arena;
+}
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+    return a.arena != b.arena;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2016-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+/* This file describes the platform-independent representation of time zone
+   rules that is built from whatever the platform-specific implementation of
+   `cdate.h` provides. Queries that need to look at many instants at once are
+   implemented on top of it instead of calling into the platform each time. */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "zone_arena.hpp"
+extern "C" {
+#include "cdate.h"
+}
+
+/* The transitions before this moment (2200-01-01T00:00:00Z) are stored in the
+   tables. The rules for later years are not likely to stay the same until
+   then, but some zones define recurring transitions indefinitely, so there has
+   to be a limit. */
+const int64_t compiled_until = 7258118400LL;
+
+/* A maximal known interval [begin; end) of UTC seconds during which the
+   offset of a time zone stays the same. */
+struct zone_period {
+    int64_t begin;
+    int64_t end;
+    int offset;
+};
+
+/* Finds the period containing the given instant. Returns false if `zone` is
+   not a valid time zone.
+   This is the only query that has to be implemented by each platform. */
+bool zone_period_at(TZID zone, int64_t epoch_sec, zone_period& period);
+
+// Returns the ids of all the zones known to the platform.
+std::vector<TZID> all_zone_ids();
+
+/* Returns a copy of the string that lives until the end of the process. Equal
+   strings are always copied to the same place. */
+const char *intern_abbreviation(const std::string& abbreviation);
+
+/* Finds the period containing the given instant during which neither the
+   offset nor the abbreviation of the zone change, and stores the abbreviation
+   interned with `intern_abbreviation`. Returns false if `zone` is not a valid
+   time zone.
+   This is implemented by each platform. */
+bool zone_abbreviation_at(TZID zone, int64_t epoch_sec, zone_period& period,
+    const char *&abbreviation);
+
+enum LOCAL_TIME_KIND {
+    // The local date-time happens exactly once.
+    LOCAL_UNIQUE,
+    // The local date-time was skipped by a transition.
+    LOCAL_GAP,
+    // The local date-time happens twice.
+    LOCAL_OVERLAP,
+};
+
+/* The result of mapping local seconds to UTC. The meaning is the same as that
+   of `local_info` in the `date` library:
+   * for `LOCAL_UNIQUE`, `first` is the only period where the date-time is;
+   * for `LOCAL_GAP`, `first` ends just before the gap, `second` starts at its
+     end;
+   * for `LOCAL_OVERLAP`, the date-time is in both `first` and `second`. */
+struct local_resolution {
+    LOCAL_TIME_KIND kind;
+    zone_period first;
+    zone_period second;
+};
+
+/* The transitions of a time zone, computed once. Only the transitions before
+   `compiled_until` are stored; later instants are queried from the platform
+   as needed, so the table is exact for any instant. */
+class zone_table {
+public:
+    /* Collects the transitions of `zone` from the platform. Returns false if
+       the zone is not valid. */
+    bool load(TZID zone);
+
+    // Makes this table describe a zone with a constant offset.
+    void load_fixed(int offset);
+
+    /* Makes this table describe a zone whose offset is `offsets[i]` starting
+       from `begins[i]`, the first of which must be INT64_MIN. The last offset
+       lasts indefinitely. */
+    void load_periods(std::vector<int64_t> begins, std::vector<int> offsets);
+
+    /* Makes the periods loaded after this be stored in `arena` instead of
+       the heap. Copying a table into this one also stores them there. */
+    void use_arena(zone_arena *arena);
+
+    bool period_at(int64_t epoch_sec, zone_period& period) const;
+
+    bool resolve_local(int64_t local_sec, local_resolution& result) const;
+
+    /* The same as `resolve_local`, but the search starts where the previous
+       date-time was found, which is kept in `cursor`, initially 0, so
+       resolving date-times in increasing order takes a single pass over the
+       transitions. The date-times may also come in any other order. */
+    bool resolve_local_from(int64_t local_sec, size_t& cursor,
+        local_resolution& result) const;
+
+    /* The greatest offset in effect at or after the given instant. The rules
+       are assumed not to introduce new offsets after `compiled_until`. */
+    int max_offset_after(int64_t epoch_sec) const;
+
+    /* The number of the stored periods. The last of them can end before
+       `compiled_until`, or it can last indefinitely. */
+    size_t period_count() const { return begins.size(); }
+
+    zone_period period(size_t i) const;
+
+private:
+    TZID id = TZID_INVALID;
+    /* `begins[i]` is the first instant when `offsets[i]` is in effect; it
+       lasts until `begins[i + 1]`, or, for the last one, until `tail_end`. */
+    std::vector<int64_t, arena_allocator<int64_t>> begins;
+    std::vector<int, arena_allocator<int>> offsets;
+    int64_t tail_end = 0;
+    /* The local date-times split into intervals: `local_begins[2 * i]` is
+       the first local second that is only in the period `i`, and
+       `local_begins[2 * i + 1]` is the first one in the gap or the overlap
+       created by the transition after it, each lasting until the next one.
+       The intervals only go as far as the stored periods; if the periods
+       don't map to ordered intervals, which doesn't happen for real zones,
+       there are none. */
+    std::vector<int64_t, arena_allocator<int64_t>> local_begins;
+    // The local second from which the intervals can't be used.
+    int64_t local_end = INT64_MIN;
+
+    // Fills the local intervals from the periods.
+    void index_local_times();
+
+    // The local date-times in `local_begins[j]` are in `result`.
+    void resolve_local_interval(size_t j, local_resolution& result) const;
+};
+
+/* Returns the table for the given zone, computing it on the first access.
+   The table lives until the end of the process.
+   Returns `nullptr` if the zone is invalid. */
+const zone_table *compiled_zone(TZID zone);
+
+/* Returns the table of a zone in a version of the time zone database loaded
+   with `tzdb_version_load`, or NULL if there's no such zone. */
+const zone_table *versioned_zone(TZDB_VERSION version, TZID zone);
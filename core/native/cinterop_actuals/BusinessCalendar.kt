@@ -0,0 +1,143 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * A calendar of working days: the given days of the week, except for the days marked as holidays, plus the days
+ * marked as working days.
+ *
+ * The working days are stored as bits, so counting them between any two dates takes constant time, and
+ * finding the date that is some number of working days away doesn't go through the dates one by one.
+ * The functions taking arrays of epoch days, that is, the numbers of days since 1970-01-01, process many dates at
+ * once.
+ *
+ * This class is not thread-safe. It holds native memory, so [close] must be called when it's no longer needed.
+ */
+public class BusinessCalendar(
+    workingDays: Set<DayOfWeek> = setOf(
+        DayOfWeek.MONDAY, DayOfWeek.TUESDAY, DayOfWeek.WEDNESDAY, DayOfWeek.THURSDAY, DayOfWeek.FRIDAY
+    )
+) {
+    private var calendar: CPointer<business_calendar>? =
+        business_calendar_create(workingDays.fold(0) { mask, day -> mask or (1 shl (day.isoDayNumber - 1)) })
+
+    private fun calendar(): CPointer<business_calendar> =
+        calendar ?: throw IllegalStateException("The business calendar is closed")
+
+    /**
+     * Makes [dates] days off regardless of their days of the week.
+     */
+    public fun markHolidays(dates: Collection<LocalDate>): Unit = setDays(dates, false)
+
+    /**
+     * Makes [dates] working days regardless of their days of the week.
+     */
+    public fun markWorkingDays(dates: Collection<LocalDate>): Unit = setDays(dates, true)
+
+    private fun setDays(dates: Collection<LocalDate>, working: Boolean) {
+        val days = IntArray(maxOf(dates.size, 1))
+        dates.forEachIndexed { i, date -> days[i] = date.toEpochDay() }
+        days.usePinned { business_calendar_set_days(calendar(), it.addressOf(0), dates.size.convert(), working) }
+    }
+
+    public fun isWorkingDay(date: LocalDate): Boolean = business_calendar_is_working_day(calendar(), date.toEpochDay())
+
+    /**
+     * Returns [date] if it's a working day, or the first working day after it otherwise.
+     *
+     * @throws DateTimeArithmeticException if there's no such date.
+     */
+    public fun nextWorkingDay(date: LocalDate): LocalDate =
+        dateOf(business_calendar_next_working_day(calendar(), date.toEpochDay())) {
+            "There is no working day on or after $date"
+        }
+
+    /**
+     * Returns the date that is [workingDays] working days after [date], or before it if [workingDays] is negative.
+     *
+     * [date] itself is not counted and doesn't have to be a working day, so, for example, adding one working day to
+     * a Saturday gives the next Monday.
+     *
+     * @throws DateTimeArithmeticException if there's no such date.
+     */
+    public fun plusWorkingDays(date: LocalDate, workingDays: Int): LocalDate =
+        dateOf(plusWorkingDays(intArrayOf(date.toEpochDay()), intArrayOf(workingDays))[0]) {
+            "There is no date $workingDays working days from $date"
+        }
+
+    /**
+     * Returns the number of working days in [[from]; [until]), or minus the number of those in [[until]; [from])
+     * if [until] is earlier.
+     */
+    public fun workingDaysBetween(from: LocalDate, until: LocalDate): Int =
+        workingDaysBetween(intArrayOf(from.toEpochDay()), intArrayOf(until.toEpochDay()))[0]
+
+    /**
+     * For each `i`, returns the epoch day that is `workingDays[i]` working days after the epoch day `epochDays[i]`,
+     * like [plusWorkingDays] does for one date, or [Int.MAX_VALUE] if there's no such date.
+     */
+    public fun plusWorkingDays(epochDays: IntArray, workingDays: IntArray): IntArray {
+        require(epochDays.size == workingDays.size) {
+            "Expected a number of working days for each of the ${epochDays.size} days, got ${workingDays.size}"
+        }
+        return bulk(epochDays, workingDays) { days, counts, results ->
+            business_calendar_add_working_days(calendar(), days, counts, results, epochDays.size.convert())
+        }
+    }
+
+    /**
+     * For each `i`, returns the number of working days between the epoch days `fromEpochDays[i]` and
+     * `untilEpochDays[i]`, like [workingDaysBetween] does for one pair of dates.
+     */
+    public fun workingDaysBetween(fromEpochDays: IntArray, untilEpochDays: IntArray): IntArray {
+        require(fromEpochDays.size == untilEpochDays.size) {
+            "Expected an end for each of the ${fromEpochDays.size} days, got ${untilEpochDays.size}"
+        }
+        return bulk(fromEpochDays, untilEpochDays) { from, until, results ->
+            business_calendar_count_working_days(calendar(), from, until, results, fromEpochDays.size.convert())
+        }
+    }
+
+    /**
+     * Releases the native memory held by the calendar. The calendar can't be used afterwards.
+     */
+    public fun close() {
+        calendar?.let { business_calendar_destroy(it) }
+        calendar = null
+    }
+}
+
+private inline fun bulk(
+    first: IntArray, second: IntArray,
+    operation: (CPointer<IntVar>, CPointer<IntVar>, CPointer<IntVar>) -> Unit
+): IntArray {
+    // `addressOf(0)` is not allowed for empty arrays.
+    if (first.isEmpty()) {
+        return IntArray(0)
+    }
+    val results = IntArray(first.size)
+    first.usePinned { pinnedFirst ->
+        second.usePinned { pinnedSecond ->
+            results.usePinned { pinnedResults ->
+                operation(pinnedFirst.addressOf(0), pinnedSecond.addressOf(0), pinnedResults.addressOf(0))
+            }
+        }
+    }
+    return results
+}
+
+private inline fun dateOf(epochDay: Int, message: () -> String): LocalDate {
+    if (epochDay == Int.MAX_VALUE) {
+        throw DateTimeArithmeticException(message())
+    }
+    return try {
+        LocalDate.ofEpochDay(epochDay)
+    } catch (e: IllegalArgumentException) {
+        throw DateTimeArithmeticException(message(), e)
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * A calendar dimension table, as used in data warehouses: a row for each day in [[from]; [until]) with the fields of
+ * its date and, for each of [zones], the instant when the day starts there and whether daylight saving time is in
+ * effect at that moment.
+ *
+ * The table is stored as columns, an array per field, with the row `i` describing the day that is `i` days after
+ * [from]. The columns that depend on the zone have the rows of each zone one after another, so the row `i` of
+ * `zones[z]` is at the index `z * size + i`.
+ *
+ * The columns are filled natively in one pass over the days for each zone, going through the transitions of the
+ * zone along with the days instead of converting each day separately.
+ *
+ * @throws IllegalArgumentException if [until] is earlier than [from], the table would have more than
+ * [Int.MAX_VALUE] rows in all the zones, or some of [zones] is not a time zone with a known set of rules.
+ * @throws RuntimeException if the rules of some time zone could not be queried.
+ */
+public class CalendarTable(public val from: LocalDate, public val until: LocalDate, public val zones: List<TimeZone>) {
+    /** The number of the days in the table. */
+    public val size: Int = until.toEpochDay() - from.toEpochDay()
+
+    init {
+        require(size >= 0) { "The end of the range $until is earlier than its start $from" }
+        require(zones.isEmpty() || size <= Int.MAX_VALUE / zones.size) {
+            "The table of $size days in ${zones.size} zones is too large"
+        }
+    }
+
+    /** The numbers of the days since 1970-01-01. */
+    public val epochDays: IntArray = IntArray(size)
+    public val years: IntArray = IntArray(size)
+    /** The numbers of the months, from 1 to 12. */
+    public val months: IntArray = IntArray(size)
+    public val daysOfMonth: IntArray = IntArray(size)
+    /** The ISO numbers of the days of the week, from 1 for Monday to 7 for Sunday. */
+    public val daysOfWeek: IntArray = IntArray(size)
+    public val daysOfYear: IntArray = IntArray(size)
+    /** The years of the ISO 8601 week dates, as in [IsoWeekDate.weekBasedYear]. */
+    public val weekBasedYears: IntArray = IntArray(size)
+    /** The weeks of the ISO 8601 week dates, as in [IsoWeekDate.weekOfWeekBasedYear]. */
+    public val weeks: IntArray = IntArray(size)
+    /** The quarters of the years, from 1 to 4. */
+    public val quarters: IntArray = IntArray(size)
+
+    /**
+     * The epoch seconds of the first moment of each day in each zone, as in [LocalDate.atStartOfDayIn]: midnight,
+     * or, if midnight was skipped by a transition, the end of the gap.
+     */
+    public val startsOfDay: LongArray = LongArray(size * zones.size)
+
+    /**
+     * Whether daylight saving time is in effect at the start of each day in each zone.
+     *
+     * The time zone database doesn't tell which offset is the standard one, so daylight saving time is taken to be in
+     * effect when the offset is greater than the smaller of the offsets at the starts of January 1 and July 1 of that
+     * year in UTC.
+     */
+    public val daylightSaving: BooleanArray = BooleanArray(size * zones.size)
+
+    init {
+        if (size > 0) {
+            fill()
+        }
+    }
+
+    /**
+     * Returns the first moment of the day in the given [row] in the zone `zones[zone]`.
+     */
+    public fun startOfDay(zone: Int, row: Int): Instant {
+        require(zone in zones.indices) { "Expected the index of one of ${zones.size} zones, got $zone" }
+        require(row in 0 until size) { "Expected the index of one of $size rows, got $row" }
+        return Instant.fromEpochSeconds(startsOfDay[zone * size + row])
+    }
+
+    private fun fill() {
+        val pins = mutableListOf<Pinned<*>>()
+        fun IntArray.address() = pin().also { pins.add(it) }.addressOf(0)
+        try {
+            memScoped {
+                val columns = alloc<calendar_columns>()
+                columns.epoch_days = epochDays.address()
+                columns.years = years.address()
+                columns.months = months.address()
+                columns.days_of_month = daysOfMonth.address()
+                columns.days_of_week = daysOfWeek.address()
+                columns.days_of_year = daysOfYear.address()
+                columns.week_based_years = weekBasedYears.address()
+                columns.weeks = weeks.address()
+                columns.quarters = quarters.address()
+                calendar_columns_fill(from.toEpochDay(), until.toEpochDay(), null, 0.convert(), columns.ptr)
+                if (zones.isEmpty()) {
+                    return@memScoped
+                }
+                val starts = startsOfDay.pin().also { pins.add(it) }
+                val saving = daylightSaving.pin().also { pins.add(it) }
+                val zoneColumns = alloc<calendar_columns>()
+                val tzid = alloc<TZIDVar>()
+                zones.forEachIndexed { z, zone ->
+                    when (zone) {
+                        is RegionTimeZone -> {
+                            tzid.value = zone.tzid
+                            zoneColumns.starts_of_day = starts.addressOf(z * size)
+                            zoneColumns.daylight_saving = saving.addressOf(z * size)
+                            if (!calendar_columns_fill(from.toEpochDay(), until.toEpochDay(), tzid.ptr, 1.convert(),
+                                    zoneColumns.ptr)) {
+                                throw RuntimeException("Unable to compute the starts of the days in zone $zone")
+                            }
+                        }
+                        is FixedOffsetTimeZone -> {
+                            val offset = zone.offset.totalSeconds
+                            for (i in 0 until size) {
+                                startsOfDay[z * size + i] = epochDays[i] * SECONDS_PER_DAY.toLong() - offset
+                            }
+                        }
+                        else -> throw IllegalArgumentException("Unsupported time zone $zone")
+                    }
+                }
+            }
+        } finally {
+            pins.forEach { it.unpin() }
+        }
+    }
+}
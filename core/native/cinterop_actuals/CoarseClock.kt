@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+
+/**
+ * A [Clock] for reading the current time very often when a precision of about a tick is enough, like when stamping
+ * many events.
+ *
+ * Once [started][start], a native thread reads the system clock every tick and publishes the time, so [now] only
+ * loads it, without a system call or a native allocation. The time returned by [now] can be behind
+ * [Clock.System.now] by up to a tick, or more if the thread is not scheduled in time.
+ *
+ * While the clock is not running, [now] reads the system clock directly, like [Clock.System].
+ */
+public object CoarseClock : Clock {
+    /**
+     * Starts the thread updating the clock every [tickMicroseconds] microseconds, or, if it's already running, makes
+     * it use the new tick.
+     *
+     * @throws IllegalArgumentException if [tickMicroseconds] is not positive.
+     * @throws RuntimeException if the thread could not be started.
+     */
+    public fun start(tickMicroseconds: Int = 1000) {
+        require(tickMicroseconds > 0) { "The tick of $tickMicroseconds microseconds is not positive" }
+        if (!coarse_clock_start(tickMicroseconds)) {
+            throw RuntimeException("Unable to start the coarse clock")
+        }
+    }
+
+    /**
+     * Stops the thread updating the clock, if it is running.
+     */
+    public fun stop() {
+        coarse_clock_stop()
+    }
+
+    /** Whether the thread updating the clock is running. */
+    public val isRunning: Boolean get() = coarse_clock_epoch_nanos() != Long.MIN_VALUE
+
+    override fun now(): Instant {
+        val epochNanos = coarse_clock_epoch_nanos()
+        if (epochNanos == Long.MIN_VALUE) {
+            return Clock.System.now()
+        }
+        return Instant(floorDiv(epochNanos, NANOS_PER_ONE.toLong()), floorMod(epochNanos, NANOS_PER_ONE.toLong()).toInt())
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * Conversions between UTC and TAI, the time scale that counts the leap seconds.
+ *
+ * TAI readings are represented like the readings of the `CLOCK_TAI` clock: as the number of seconds since the epoch
+ * that UTC would show, plus the difference TAI − UTC in effect then. The difference of 10 seconds that was in effect in
+ * 1972 is used for the earlier instants.
+ *
+ * The table of leap seconds is loaded from the system on first use, where available, or with [load].
+ */
+public object LeapSeconds {
+    /**
+     * Loads the table of leap seconds from a TZif file with leap second records, like
+     * `/usr/share/zoneinfo/right/UTC`, or from a file in the format of the `leapseconds` file of the time zone
+     * database, replacing the table used before.
+     *
+     * @throws IllegalArgumentException if the file could not be read.
+     */
+    public fun load(path: String) {
+        require(leap_seconds_load(path)) { "Unable to load the leap seconds from '$path'" }
+    }
+
+    /**
+     * Converts the numbers of seconds since the epoch in UTC to TAI readings.
+     *
+     * @throws IllegalStateException if no table of leap seconds is available.
+     */
+    public fun utcToTai(epochSeconds: LongArray): LongArray = convert(epochSeconds, ::utc_to_tai)
+
+    /**
+     * Converts TAI readings to the numbers of seconds since the epoch in UTC.
+     * The inserted leap seconds are mapped to the UTC second that follows them.
+     *
+     * @throws IllegalStateException if no table of leap seconds is available.
+     */
+    public fun taiToUtc(taiSeconds: LongArray): LongArray = convert(taiSeconds, ::tai_to_utc)
+
+    /**
+     * Returns the current TAI reading as an [Instant], which is ahead of [Clock.System.now] by TAI − UTC.
+     *
+     * The system TAI clock is used if the system knows its offset from UTC; otherwise, the current time is converted
+     * with the table of leap seconds.
+     *
+     * @throws IllegalStateException if the current TAI reading can't be obtained.
+     */
+    public fun taiNow(): Instant = memScoped {
+        val seconds = alloc<LongVar>()
+        val nanoseconds = alloc<IntVar>()
+        check(current_time_tai(seconds.ptr, nanoseconds.ptr)) { "Unable to read the current TAI time" }
+        Instant(seconds.value, nanoseconds.value)
+    }
+
+    private inline fun convert(
+        seconds: LongArray,
+        conversion: (CValuesRef<LongVar>?, CValuesRef<LongVar>?, size_t) -> Boolean
+    ): LongArray {
+        val result = LongArray(seconds.size)
+        if (seconds.isEmpty()) {
+            return result
+        }
+        val success = seconds.usePinned { input ->
+            result.usePinned { output ->
+                conversion(input.addressOf(0), output.addressOf(0), seconds.size.convert())
+            }
+        }
+        check(success) { "No table of leap seconds is available" }
+        return result
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * How a local date-time maps to the instants in a time zone.
+ */
+public enum class LocalDateTimeKind {
+    /** The date-time happens exactly once. */
+    UNIQUE,
+
+    /** The date-time doesn't happen, having fallen into the gap created by a transition to a greater offset. */
+    GAP,
+
+    /** The date-time happens twice because of a transition to a lesser offset. */
+    OVERLAP;
+}
+
+/**
+ * The classification of local date-times in a time zone, with the offsets around each of them.
+ *
+ * For the date-time `i`, `offsetsBefore[i]` and `offsetsAfter[i]` are the offsets in seconds in effect before and
+ * after the transition that creates the gap or the overlap containing it; if the date-time is unique, both are its
+ * only offset.
+ */
+public class LocalDateTimeClassification internal constructor(
+    public val offsetsBefore: IntArray,
+    public val offsetsAfter: IntArray,
+) {
+    /** The number of the classified date-times. */
+    public val size: Int get() = offsetsBefore.size
+
+    public fun kind(index: Int): LocalDateTimeKind = when {
+        offsetsAfter[index] > offsetsBefore[index] -> LocalDateTimeKind.GAP
+        offsetsAfter[index] < offsetsBefore[index] -> LocalDateTimeKind.OVERLAP
+        else -> LocalDateTimeKind.UNIQUE
+    }
+
+    /**
+     * Returns the offsets at which the date-time with the given [index] happens: none if it is in a gap, one if it is
+     * unique, and two if it is in an overlap, the offset of the earlier instant first.
+     */
+    public fun validOffsets(index: Int): List<UtcOffset> = when (kind(index)) {
+        LocalDateTimeKind.UNIQUE -> listOf(UtcOffset.ofSeconds(offsetsBefore[index]))
+        LocalDateTimeKind.GAP -> emptyList()
+        LocalDateTimeKind.OVERLAP ->
+            listOf(UtcOffset.ofSeconds(offsetsBefore[index]), UtcOffset.ofSeconds(offsetsAfter[index]))
+    }
+}
+
+/**
+ * Classifies the local date-times given as the numbers of seconds since 1970-01-01T00:00 as unique, skipped, or
+ * repeated in this time zone, without converting each of them to an instant.
+ *
+ * The classification is done natively in a single pass over the transitions of the time zone if the date-times are
+ * sorted; otherwise, it takes a search for each date-time that is earlier than the previous one.
+ *
+ * @throws IllegalArgumentException if this is not a time zone with a known set of rules.
+ * @throws RuntimeException if the rules of the time zone could not be queried.
+ */
+public fun TimeZone.classifyLocalDateTimes(localEpochSeconds: LongArray): LocalDateTimeClassification {
+    val before = IntArray(localEpochSeconds.size)
+    val after = IntArray(localEpochSeconds.size)
+    when (this) {
+        is RegionTimeZone -> if (localEpochSeconds.isNotEmpty()) {
+            localEpochSeconds.usePinned { locals ->
+                before.usePinned { pinnedBefore ->
+                    after.usePinned { pinnedAfter ->
+                        if (!classify_local_datetimes(tzid, locals.addressOf(0), localEpochSeconds.size.convert(),
+                                pinnedBefore.addressOf(0), pinnedAfter.addressOf(0))) {
+                            throw RuntimeException("Unable to classify the local date-times in zone $this")
+                        }
+                    }
+                }
+            }
+        }
+        is FixedOffsetTimeZone -> {
+            before.fill(offset.totalSeconds)
+            after.fill(offset.totalSeconds)
+        }
+        else -> throw IllegalArgumentException("Unsupported time zone $this")
+    }
+    return LocalDateTimeClassification(before, after)
+}
+
+/**
+ * Classifies the [dateTimes] as unique, skipped, or repeated in this time zone, like [classifyLocalDateTimes] for
+ * their numbers of seconds since 1970-01-01T00:00. The fractions of a second are ignored.
+ */
+public fun TimeZone.classifyLocalDateTimes(dateTimes: List<LocalDateTime>): LocalDateTimeClassification =
+    classifyLocalDateTimes(LongArray(dateTimes.size) { dateTimes[it].toEpochSecond(UtcOffset.ZERO) })
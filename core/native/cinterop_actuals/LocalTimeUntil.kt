@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * Returns the number of seconds from the start of the current second until the next moment, possibly the current one,
+ * when the local time in this time zone is [time], like "how long until 18:00 in Berlin".
+ *
+ * If the time is skipped by a transition on some day, it is moved forward by the length of the gap, as
+ * [LocalDateTime.toInstant] does, so 02:30 in a gap from 02:00 to 03:00 happens at 03:30.
+ * If it happens twice, the earlier occurrence is taken unless it's already in the past.
+ * The fraction of a second of [time] is ignored.
+ *
+ * The current time is read and the answer is computed with a single native call.
+ *
+ * @throws IllegalArgumentException if this is not a time zone with a known set of rules.
+ * @throws RuntimeException if the current time or the rules of the time zone could not be queried.
+ */
+public fun TimeZone.secondsUntilNext(time: LocalTime): Long = when (this) {
+    is RegionTimeZone -> seconds_until_local_time(tzid, time.toSecondOfDay()).also {
+        if (it == Long.MAX_VALUE) {
+            throw RuntimeException("Unable to compute the time until $time in zone $this")
+        }
+    }
+    is FixedOffsetTimeZone -> secondsUntilAtOffset(offset, time, Clock.System.now().epochSeconds)
+    else -> throw IllegalArgumentException("Unsupported time zone $this")
+}
+
+/**
+ * For each `i`, returns the number of seconds from the start of the second of [now] until the next moment when the
+ * local time in `zones[i]` is `times[i]`, like [TimeZone.secondsUntilNext] does for the current time.
+ *
+ * @throws IllegalArgumentException if [zones] and [times] have different sizes, or some of [zones] is not a time zone
+ * with a known set of rules.
+ * @throws RuntimeException if the rules of some time zone could not be queried.
+ */
+public fun TimeZone.Companion.secondsUntilNext(
+    zones: List<TimeZone>,
+    times: List<LocalTime>,
+    now: Instant = Clock.System.now(),
+): LongArray {
+    require(zones.size == times.size) { "Expected a time for each of the ${zones.size} zones, got ${times.size}" }
+    val results = LongArray(zones.size)
+    val regions = zones.indices.filter { zones[it] is RegionTimeZone }
+    zones.forEachIndexed { i, zone ->
+        when (zone) {
+            is RegionTimeZone -> {}
+            is FixedOffsetTimeZone -> results[i] = secondsUntilAtOffset(zone.offset, times[i], now.epochSeconds)
+            else -> throw IllegalArgumentException("Unsupported time zone $zone")
+        }
+    }
+    if (regions.isEmpty()) {
+        return results
+    }
+    memScoped {
+        val ids = allocArray<TZIDVar>(regions.size)
+        val secondsOfDay = allocArray<IntVar>(regions.size)
+        val regionResults = allocArray<LongVar>(regions.size)
+        regions.forEachIndexed { j, i ->
+            ids[j] = (zones[i] as RegionTimeZone).tzid
+            secondsOfDay[j] = times[i].toSecondOfDay()
+        }
+        if (!seconds_until_local_times(ids, secondsOfDay, regions.size.convert(), now.epochSeconds, regionResults)) {
+            throw RuntimeException("Unable to compute the time until the local times in zones $zones")
+        }
+        regions.forEachIndexed { j, i -> results[i] = regionResults[j] }
+    }
+    return results
+}
+
+private fun secondsUntilAtOffset(offset: UtcOffset, time: LocalTime, nowEpochSeconds: Long): Long {
+    val secondOfDay = floorMod(nowEpochSeconds + offset.totalSeconds, SECONDS_PER_DAY.toLong())
+    return floorMod(time.toSecondOfDay() - secondOfDay, SECONDS_PER_DAY.toLong())
+}
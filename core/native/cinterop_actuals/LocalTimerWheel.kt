@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * A set of timers that fire at the given local date-times in time zones.
+ *
+ * The instants when the timers fire are computed from the rules of the time zones as the timers approach, so
+ * scheduling a timer is cheap even if it's far in the future.
+ * A local date-time that falls into a gap fires at the end of the gap, and one in an overlap fires at
+ * the earlier of the two instants, just like [LocalDate.atStartOfDayIn] does.
+ *
+ * The timers don't fire on their own: [advance] should be called to move the time forward and collect the timers
+ * that fired.
+ *
+ * This class is not thread-safe. It holds native memory, so [close] must be called when it's no longer needed.
+ */
+public class LocalTimerWheel(now: Instant) {
+    private var wheel: CPointer<timer_wheel>? = timer_wheel_create(now.epochSeconds)
+
+    private fun wheel(): CPointer<timer_wheel> = wheel ?: throw IllegalStateException("The timer wheel is closed")
+
+    /**
+     * The number of timers that are scheduled and did not fire yet.
+     */
+    public val size: Int get() = timer_wheel_size(wheel()).toInt()
+
+    /**
+     * Schedules a timer firing at [dateTime] in [timeZone], to be reported with [payload], and returns its id.
+     *
+     * If [repeatDays] is positive, each time the timer fires, it is scheduled again at the same local time
+     * [repeatDays] days later.
+     * The nanoseconds of [dateTime] are ignored.
+     */
+    public fun schedule(dateTime: LocalDateTime, timeZone: TimeZone, payload: Long, repeatDays: Int = 0): Long {
+        require(repeatDays >= 0) { "The number of days between firings must not be negative, got $repeatDays" }
+        val localSeconds = dateTime.toEpochSecond(UtcOffset.ZERO)
+        val id = when (timeZone) {
+            is RegionTimeZone ->
+                timer_wheel_schedule(wheel(), timeZone.tzid, localSeconds, repeatDays, payload.toULong())
+            is FixedOffsetTimeZone ->
+                timer_wheel_schedule_at_offset(wheel(), timeZone.offset.totalSeconds, localSeconds, repeatDays,
+                    payload.toULong())
+            else -> throw IllegalArgumentException("Unsupported time zone $timeZone")
+        }
+        if (id < 0) {
+            throw RuntimeException("Unable to schedule a timer at $dateTime in zone $timeZone")
+        }
+        return id
+    }
+
+    /**
+     * Cancels the timer with the given id. Returns `false` if it already fired or was cancelled.
+     */
+    public fun cancel(timerId: Long): Boolean = timer_wheel_cancel(wheel(), timerId)
+
+    /**
+     * Moves the time forward to [now] and returns the payloads of the timers that fired, in the order of firing.
+     */
+    public fun advance(now: Instant): LongArray = memScoped {
+        val buffer = allocArray<ULongVar>(ADVANCE_BUFFER_SIZE)
+        var result = LongArray(0)
+        do {
+            val count = timer_wheel_advance(wheel(), now.epochSeconds, buffer, ADVANCE_BUFFER_SIZE.convert()).toInt()
+            val offset = result.size
+            result = result.copyOf(offset + count)
+            for (i in 0 until count) {
+                result[offset + i] = buffer[i].toLong()
+            }
+        } while (count == ADVANCE_BUFFER_SIZE)
+        result
+    }
+
+    /**
+     * Releases the native memory held by the timers. The wheel can't be used afterwards.
+     */
+    public fun close() {
+        wheel?.let { timer_wheel_destroy(it) }
+        wheel = null
+    }
+}
+
+private const val ADVANCE_BUFFER_SIZE = 1024
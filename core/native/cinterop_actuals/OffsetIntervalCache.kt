@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+import kotlin.native.concurrent.*
+
+/**
+ * The numbers of the lookups of the offsets of a time zone at instants that were answered from the intervals cached
+ * in the time zone, [hits], and by the native code, [misses], while the statistics were [enabled].
+ */
+public class OffsetCacheStatistics(public val hits: Long, public val misses: Long) {
+    override fun equals(other: Any?): Boolean =
+        this === other || other is OffsetCacheStatistics && hits == other.hits && misses == other.misses
+
+    override fun hashCode(): Int = hits.hashCode() * 31 + misses.hashCode()
+
+    override fun toString(): String = "OffsetCacheStatistics(hits=$hits, misses=$misses)"
+
+    public companion object {
+        /**
+         * Whether the lookups are counted; `false` by default.
+         *
+         * Counting a lookup is an atomic update of a counter shared by all the threads using the time zone, which
+         * costs more than the lookup itself when the threads contend, so it's only worth enabling while measuring.
+         */
+        public var enabled: Boolean
+            get() = statisticsEnabled.value != 0
+            set(value) {
+                statisticsEnabled.value = if (value) 1 else 0
+            }
+    }
+}
+
+@SharedImmutable
+private val statisticsEnabled = AtomicInt(0)
+
+/**
+ * Returns the statistics of the cache of the offsets of this time zone.
+ * Only the region-based time zones have such a cache; for the others, both numbers are zero.
+ */
+public fun TimeZone.offsetCacheStatistics(): OffsetCacheStatistics = when (this) {
+    is RegionTimeZone -> offsetIntervals.statistics()
+    else -> OffsetCacheStatistics(0, 0)
+}
+
+// An interval [from; until) of epoch seconds during which the offset of a time zone is [offset].
+private class OffsetInterval(val from: Long, val until: Long, val offset: UtcOffset)
+
+/**
+ * The intervals of the offsets of a time zone that were looked up recently, so that the offsets at the instants close
+ * to the recent ones are found without calling into the native code.
+ *
+ * The intervals are kept in an immutable array, the most recent first, which is replaced as a whole when an interval
+ * is added, so any thread can read it without locking. If several threads add intervals at once, some of them may
+ * be lost, which only costs another native call later.
+ */
+internal class OffsetIntervalCache(private val tzid: TZID) {
+    private val intervals = AtomicReference(emptyArray<OffsetInterval>().freeze())
+    private val hits = AtomicLong(0)
+    private val misses = AtomicLong(0)
+
+    /**
+     * Returns the offset at [epochSeconds], or `null` if the native code could not find it.
+     */
+    fun offsetAt(epochSeconds: Long): UtcOffset? {
+        val current = intervals.value
+        for (interval in current) {
+            if (epochSeconds >= interval.from && epochSeconds < interval.until) {
+                if (statisticsEnabled.value != 0) {
+                    hits.addAndGet(1)
+                }
+                return interval.offset
+            }
+        }
+        if (statisticsEnabled.value != 0) {
+            misses.addAndGet(1)
+        }
+        val interval = memScoped {
+            val from = alloc<LongVar>()
+            val until = alloc<LongVar>()
+            val offset = offset_at_instant_with_validity(tzid, epochSeconds, from.ptr, until.ptr)
+            if (offset == Int.MAX_VALUE) {
+                return null
+            }
+            OffsetInterval(from.value, until.value, UtcOffset.ofSeconds(offset))
+        }
+        // The platform may clamp the instants that are too far away, so the interval might not contain this one.
+        if (epochSeconds >= interval.from && epochSeconds < interval.until) {
+            val size = minOf(current.size + 1, MAX_OFFSET_INTERVALS)
+            intervals.value = Array(size) { if (it == 0) interval else current[it - 1] }.freeze()
+        }
+        return interval.offset
+    }
+
+    fun statistics(): OffsetCacheStatistics = OffsetCacheStatistics(hits.value, misses.value)
+}
+
+// Enough for the instants around a transition and a few unrelated ones.
+private const val MAX_OFFSET_INTERVALS = 4
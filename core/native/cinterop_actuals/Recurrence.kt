@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+import platform.posix.*
+
+public enum class RecurrenceFrequency {
+    DAILY,
+    WEEKLY,
+    MONTHLY;
+}
+
+/**
+ * Describes the local dates and the local time of day of a recurring event,
+ * for example, "every other weekday at 09:00" or "the last day of each month at 18:30".
+ *
+ * The rule applies every [interval] days, weeks, or months, depending on [frequency],
+ * counting from the day, the week, or the month containing [start].
+ * There are no occurrences before [start], which must be in the years from -32767 to 32767.
+ */
+public class RecurrenceRule private constructor(
+    public val frequency: RecurrenceFrequency,
+    public val start: LocalDate,
+    public val hour: Int,
+    public val minute: Int,
+    public val second: Int,
+    public val interval: Int,
+    /** The days of the week of the occurrences for [RecurrenceFrequency.WEEKLY], empty otherwise. */
+    public val daysOfWeek: Set<DayOfWeek>,
+    /**
+     * The day of the month of the occurrences for [RecurrenceFrequency.MONTHLY], 0 otherwise.
+     *
+     * Negative values count from the end of the month: -1 is the last day.
+     * Months without such a day are skipped.
+     */
+    public val dayOfMonth: Int,
+) {
+    init {
+        require(hour in 0..23) { "Invalid time: hour must be a number between 0 and 23, got $hour" }
+        require(minute in 0..59) { "Invalid time: minute must be a number between 0 and 59, got $minute" }
+        require(second in 0..59) { "Invalid time: second must be a number between 0 and 59, got $second" }
+        require(interval > 0) { "The interval must be positive, got $interval" }
+        require(start.year in -32767..32767) { "The start must be in the years from -32767 to 32767, got $start" }
+    }
+
+    public companion object {
+        public fun daily(start: LocalDate, hour: Int, minute: Int, second: Int = 0, interval: Int = 1): RecurrenceRule =
+            RecurrenceRule(RecurrenceFrequency.DAILY, start, hour, minute, second, interval, emptySet(), 0)
+
+        public fun weekly(
+            start: LocalDate, daysOfWeek: Set<DayOfWeek>, hour: Int, minute: Int, second: Int = 0, interval: Int = 1
+        ): RecurrenceRule {
+            require(daysOfWeek.isNotEmpty()) { "At least one day of the week must be specified" }
+            return RecurrenceRule(RecurrenceFrequency.WEEKLY, start, hour, minute, second, interval, daysOfWeek, 0)
+        }
+
+        public fun monthly(
+            start: LocalDate, dayOfMonth: Int, hour: Int, minute: Int, second: Int = 0, interval: Int = 1
+        ): RecurrenceRule {
+            require(dayOfMonth != 0 && dayOfMonth in -31..31) {
+                "The day of month must be a number between 1 and 31 or between -31 and -1, got $dayOfMonth"
+            }
+            return RecurrenceRule(RecurrenceFrequency.MONTHLY, start, hour, minute, second, interval, emptySet(), dayOfMonth)
+        }
+    }
+
+    internal fun toNative(rule: recurrence_rule) {
+        rule.frequency = when (frequency) {
+            RecurrenceFrequency.DAILY -> RECURRENCE_FREQUENCY.RECURRENCE_DAILY
+            RecurrenceFrequency.WEEKLY -> RECURRENCE_FREQUENCY.RECURRENCE_WEEKLY
+            RecurrenceFrequency.MONTHLY -> RECURRENCE_FREQUENCY.RECURRENCE_MONTHLY
+        }
+        rule.interval = interval
+        rule.start_epoch_day = start.toEpochDay().toLong()
+        rule.second_of_day = hour * SECONDS_PER_HOUR + minute * SECONDS_PER_MINUTE + second
+        rule.days_of_week = daysOfWeek.fold(0) { mask, day -> mask or (1 shl day.ordinal) }
+        rule.day_of_month = dayOfMonth
+    }
+
+    override fun toString(): String =
+        "RecurrenceRule($frequency, start=$start, time=$hour:$minute:$second, interval=$interval" +
+            (if (daysOfWeek.isNotEmpty()) ", daysOfWeek=$daysOfWeek" else "") +
+            (if (dayOfMonth != 0) ", dayOfMonth=$dayOfMonth" else "") + ")"
+}
+
+// The epoch second of the first whole second that is not earlier than the instant.
+private fun Instant.ceilingEpochSeconds(): Long =
+    if (nanosecondsOfSecond > 0) epochSeconds + 1 else epochSeconds
+
+/**
+ * Returns the epoch seconds of the occurrences of [rule] in this time zone that are in [[from]; [until]),
+ * in increasing order and without duplicates.
+ *
+ * The occurrences that fall into a gap or an overlap created by a time zone transition are handled
+ * according to [gapHandling] and [overlapHandling].
+ * Only the occurrences in the years from -32767 to 32767 are computed.
+ *
+ * @throws IllegalArgumentException if this is not a time zone with a known set of rules.
+ * @throws RuntimeException if the rules of the time zone could not be queried, or the range contains more than
+ * 10 million days with occurrences.
+ */
+public fun TimeZone.recurrenceInstants(
+    rule: RecurrenceRule,
+    from: Instant,
+    until: Instant,
+    gapHandling: GapHandling = GapHandling.MOVE_FORWARD,
+    overlapHandling: OverlapHandling = OverlapHandling.EARLIER,
+): LongArray = memScoped {
+    val nativeRule = alloc<recurrence_rule>()
+    rule.toNative(nativeRule)
+    val count = alloc<size_tVar>()
+    val fromSeconds = from.ceilingEpochSeconds()
+    val untilSeconds = until.ceilingEpochSeconds()
+    val zone = this@recurrenceInstants
+    val array = when (zone) {
+        is RegionTimeZone -> expand_recurrence(zone.tzid, nativeRule.ptr, fromSeconds, untilSeconds,
+            gapHandling.toNative(), overlapHandling.toNative(), count.ptr)
+        is FixedOffsetTimeZone -> expand_recurrence_at_offset(zone.offset.totalSeconds, nativeRule.ptr,
+            fromSeconds, untilSeconds, count.ptr)
+        else -> throw IllegalArgumentException("Unsupported time zone $zone")
+    } ?: throw RuntimeException("Unable to compute the occurrences of $rule in zone $zone")
+    try {
+        LongArray(count.value.toInt()) { array[it] }
+    } finally {
+        free(array)
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+import platform.posix.free
+
+/**
+ * A version of the time zone database, loaded independently of the one the system provides.
+ *
+ * This allows reproducing the computations done with the time zone rules that were in effect at some point, and
+ * several versions can be used side by side. The versions that have the same rules for a time zone share the
+ * memory needed for it.
+ */
+public class TimeZoneDatabase private constructor(internal val version: TZDB_VERSION, private val directory: String) {
+    public companion object {
+        /**
+         * Loads a version of the time zone database from a [directory] of TZif files, such as a copy of
+         * `/usr/share/zoneinfo` made while the version was current.
+         *
+         * The recurring rules of the time zones are only followed until the year 2200.
+         * The loaded versions stay in memory until the end of the process.
+         *
+         * @throws IllegalArgumentException if there are no time zones in [directory].
+         */
+        public fun load(directory: String): TimeZoneDatabase {
+            val version = tzdb_version_load(directory)
+            require(version != TZDB_VERSION_INVALID) { "Unable to load the time zone database from '$directory'" }
+            return TimeZoneDatabase(version, directory)
+        }
+    }
+
+    /**
+     * The IDs of the time zones in this version.
+     */
+    public val availableZoneIds: Set<String> by lazy {
+        val count = tzdb_version_zone_count(version).toInt()
+        (0 until count).mapTo(mutableSetOf()) { zoneName(it.convert()) }
+    }
+
+    /**
+     * Returns the time zone with the given ID, following the rules of this version.
+     *
+     * @throws IllegalTimeZoneException if there's no such time zone in this version.
+     */
+    public fun zone(zoneId: String): TimeZone {
+        val tzid = tzdb_version_zone_by_name(version, zoneId)
+        if (tzid == TZID_INVALID) {
+            throw IllegalTimeZoneException("No timezone found with zone ID '$zoneId' in the database at '$directory'")
+        }
+        return VersionedTimeZone(this, tzid, zoneId)
+    }
+
+    /**
+     * Returns the maximal ranges of instants in [[from]; [until]) where the offsets of the time zones in this version
+     * differ from the ones in the [old] version, ordered by the IDs of the time zones, then by time.
+     *
+     * A time zone that is only present in one of the versions differs in the whole range.
+     * The time zones whose rules are the same in both versions are skipped without examining them.
+     */
+    public fun differencesFrom(old: TimeZoneDatabase, from: Instant, until: Instant): List<TimeZoneDifference> =
+        memScoped {
+            val untilSeconds = if (until.nanosecondsOfSecond > 0) until.epochSeconds + 1 else until.epochSeconds
+            val count = alloc<size_tVar>()
+            val differences = tzdb_version_diff(old.version, version, from.epochSeconds, untilSeconds, count.ptr)
+                ?: throw RuntimeException("Unable to compare $old with $this")
+            try {
+                List(count.value.toInt()) {
+                    val difference = differences[it]
+                    val zoneId = if (difference.new_zone != TZID_INVALID) {
+                        zoneName(difference.new_zone)
+                    } else {
+                        old.zoneName(difference.old_zone)
+                    }
+                    TimeZoneDifference(zoneId,
+                        maxOf(Instant.fromEpochSeconds(difference.begin), from),
+                        minOf(Instant.fromEpochSeconds(difference.end), until))
+                }
+            } finally {
+                free(differences)
+            }
+        }
+
+    private fun zoneName(tzid: TZID): String = tzdb_version_zone_name(version, tzid)?.toKString()
+        ?: throw RuntimeException("Unable to acquire the name of the timezone with id $tzid")
+
+    override fun toString(): String = "TimeZoneDatabase($directory)"
+}
+
+/**
+ * A range of instants [[from]; [until]) where the offsets of the time zone [zoneId] differ between two versions of
+ * the time zone database.
+ */
+public class TimeZoneDifference internal constructor(
+    public val zoneId: String,
+    public val from: Instant,
+    public val until: Instant
+) {
+    override fun equals(other: Any?): Boolean =
+        this === other || other is TimeZoneDifference && zoneId == other.zoneId && from == other.from &&
+            until == other.until
+
+    override fun hashCode(): Int = (zoneId.hashCode() * 31 + from.hashCode()) * 31 + until.hashCode()
+
+    override fun toString(): String = "$zoneId: [$from; $until)"
+}
+
+internal class VersionedTimeZone(
+    private val database: TimeZoneDatabase, internal val tzid: TZID, override val id: String
+) : TimeZone() {
+    private val version get() = database.version
+
+    override val rulesVersion: Any? get() = version
+
+    override fun atStartOfDay(date: LocalDate): Instant {
+        val epochSeconds = LocalDateTime(date, LocalTime.MIN).toEpochSecond(UtcOffset.ZERO)
+        val midnightInstantSeconds = tzdb_version_at_start_of_day(version, tzid, epochSeconds)
+        if (midnightInstantSeconds == Long.MAX_VALUE) {
+            throw RuntimeException("Unable to acquire the time of start of day at $date for zone $this")
+        }
+        return Instant(midnightInstantSeconds, 0)
+    }
+
+    override fun atZone(dateTime: LocalDateTime, preferred: UtcOffset?): ZonedDateTime = memScoped {
+        val epochSeconds = dateTime.toEpochSecond(UtcOffset.ZERO)
+        val offset = alloc<IntVar>()
+        offset.value = preferred?.totalSeconds ?: Int.MAX_VALUE
+        val transitionDuration = tzdb_version_offset_at_datetime(version, tzid, epochSeconds, offset.ptr)
+        if (offset.value == Int.MAX_VALUE) {
+            throw RuntimeException("Unable to acquire the offset at $dateTime for zone ${this@VersionedTimeZone}")
+        }
+        val correctedDateTime = try {
+            dateTime.plusSeconds(transitionDuration)
+        } catch (e: IllegalArgumentException) {
+            throw DateTimeArithmeticException("Overflow whet correcting the date-time to not be in the transition gap", e)
+        } catch (e: ArithmeticException) {
+            throw RuntimeException("Anomalously long timezone transition gap reported", e)
+        }
+        ZonedDateTime(correctedDateTime, this@VersionedTimeZone, UtcOffset.ofSeconds(offset.value))
+    }
+
+    override fun offsetAtImpl(instant: Instant): UtcOffset {
+        val offset = tzdb_version_offset_at_instant(version, tzid, instant.epochSeconds)
+        if (offset == Int.MAX_VALUE) {
+            throw RuntimeException("Unable to acquire the offset at instant $instant for zone $this")
+        }
+        return UtcOffset.ofSeconds(offset)
+    }
+
+}
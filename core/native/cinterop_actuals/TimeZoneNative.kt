@@ -8,14 +8,14 @@ import kotlinx.datetime.internal.*
 import kotlinx.cinterop.*
 import platform.posix.free
 
-internal actual class RegionTimeZone(private val tzid: TZID, actual override val id: String): TimeZone() {
+internal actual class RegionTimeZone(internal val tzid: TZID, actual override val id: String): TimeZone() {
     actual companion object {
-        actual fun of(zoneId: String): RegionTimeZone {
+        actual fun of(zoneId: String): RegionTimeZone = regionTimeZonesByName.getOrPut(zoneId) {
             val tzid = timezone_by_name(zoneId)
             if (tzid == TZID_INVALID) {
                 throw IllegalTimeZoneException("No timezone found with zone ID '$zoneId'")
             }
-            return RegionTimeZone(tzid, zoneId)
+            RegionTimeZone(tzid, zoneId)
         }
 
         actual fun currentSystemDefault(): RegionTimeZone = memScoped {
@@ -73,13 +73,12 @@ internal actual class RegionTimeZone(private val tzid: TZID, actual override val
         ZonedDateTime(correctedDateTime, this@RegionTimeZone, UtcOffset.ofSeconds(offset.value))
     }
 
-    actual override fun offsetAtImpl(instant: Instant): UtcOffset {
-        val offset = offset_at_instant(tzid, instant.epochSeconds)
-        if (offset == Int.MAX_VALUE) {
-            throw RuntimeException("Unable to acquire the offset at instant $instant for zone $this")
-        }
-        return UtcOffset.ofSeconds(offset)
-    }
+    // The offsets looked up recently, which also serve the conversions of instants to local date-times.
+    internal val offsetIntervals = OffsetIntervalCache(tzid)
+
+    actual override fun offsetAtImpl(instant: Instant): UtcOffset =
+        offsetIntervals.offsetAt(instant.epochSeconds)
+            ?: throw RuntimeException("Unable to acquire the offset at instant $instant for zone $this")
 
 }
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+
+/**
+ * Specifies what to do with a local date-time that doesn't exist in a time zone,
+ * having fallen into the gap created by a transition to a greater offset.
+ */
+public enum class GapHandling {
+    /**
+     * Moves the date-time forward by the length of the gap, which is the same as interpreting it with the offset
+     * that was in effect before the gap.
+     */
+    MOVE_FORWARD,
+
+    /**
+     * Replaces the date-time with the first moment after the gap.
+     */
+    NEXT_CORRECT,
+
+    /**
+     * Drops the date-time altogether.
+     */
+    SKIP;
+}
+
+/**
+ * Specifies what to do with a local date-time that happens twice in a time zone because of
+ * a transition to a lesser offset.
+ */
+public enum class OverlapHandling {
+    /** Uses the earlier of the two instants. */
+    EARLIER,
+
+    /** Uses the later of the two instants. */
+    LATER,
+
+    /** Uses both instants. */
+    BOTH;
+}
+
+internal fun GapHandling.toNative(): GAP_HANDLING = when (this) {
+    GapHandling.MOVE_FORWARD -> GAP_HANDLING.GAP_HANDLING_MOVE_FORWARD
+    GapHandling.NEXT_CORRECT -> GAP_HANDLING.GAP_HANDLING_NEXT_CORRECT
+    GapHandling.SKIP -> GAP_HANDLING.GAP_HANDLING_SKIP
+}
+
+internal fun OverlapHandling.toNative(): OVERLAP_HANDLING = when (this) {
+    OverlapHandling.EARLIER -> OVERLAP_HANDLING.OVERLAP_HANDLING_EARLIER
+    OverlapHandling.LATER -> OVERLAP_HANDLING.OVERLAP_HANDLING_LATER
+    OverlapHandling.BOTH -> OVERLAP_HANDLING.OVERLAP_HANDLING_BOTH
+}
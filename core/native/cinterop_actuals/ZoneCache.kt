@@ -0,0 +1,52 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlin.native.concurrent.*
+
+/**
+ * A map that any thread can read without locking.
+ *
+ * The whole map is replaced on each addition, so this is only suitable for the sets of keys that stop growing soon,
+ * like the time zones used by a program. The values are frozen.
+ */
+internal class ConcurrentCache<K : Any, V : Any> {
+    private val entries = AtomicReference<Map<K, V>>(emptyMap<K, V>().freeze())
+
+    operator fun get(key: K): V? = entries.value[key]
+
+    /**
+     * Returns the value for [key], computing it with [compute] if there is none.
+     * If several threads compute the value at once, all of them return the one that was stored first.
+     */
+    inline fun getOrPut(key: K, compute: () -> V): V {
+        get(key)?.let { return it }
+        return put(key, compute())
+    }
+
+    fun put(key: K, value: V): V {
+        value.freeze()
+        while (true) {
+            val current = entries.value
+            current[key]?.let { return it }
+            val updated = HashMap(current).apply { put(key, value) }.freeze()
+            if (entries.compareAndSet(current, updated)) {
+                return value
+            }
+        }
+    }
+}
+
+/**
+ * The region-based time zones by the names they were requested with, so that obtaining a time zone that was
+ * already requested doesn't call into the native code.
+ */
+@SharedImmutable
+internal val regionTimeZonesByName = ConcurrentCache<String, RegionTimeZone>()
+
+// The region-based time zones with their canonical names by their ids.
+@SharedImmutable
+internal val regionTimeZonesById = ConcurrentCache<TZID, RegionTimeZone>()
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+package kotlinx.datetime
+
+import kotlinx.datetime.internal.*
+import kotlinx.cinterop.*
+import platform.posix.*
+
+internal fun regionTimeZoneById(tzid: TZID): RegionTimeZone = regionTimeZonesById.getOrPut(tzid) {
+    val name = timezone_name_by_id(tzid)?.toKString()
+        ?: throw RuntimeException("Unable to acquire the name of the timezone with id $tzid")
+    RegionTimeZone(tzid, name)
+}
+
+/**
+ * Converts the array of [count] ids returned by the native code to time zones, then frees it.
+ */
+internal fun CPointer<TZIDVar>.toTimeZones(count: Int): List<TimeZone> = try {
+    List(count) { regionTimeZoneById(this[it]) }
+} finally {
+    free(this)
+}
+
+/**
+ * Returns the time zones with the given ids, like [TimeZone.of] does for each of them.
+ *
+ * The region-based time zones that were not requested before are looked up by the native code all at once.
+ *
+ * @throws IllegalTimeZoneException if some of [zoneIds] is not a valid time zone id.
+ */
+public fun TimeZone.Companion.ofAll(zoneIds: List<String>): List<TimeZone> {
+    val zones = arrayOfNulls<TimeZone>(zoneIds.size)
+    val missing = LinkedHashSet<String>()
+    zoneIds.forEachIndexed { i, zoneId ->
+        val zone = regionTimeZonesByName[zoneId] ?: fixedOffsetTimeZoneOrNull(zoneId)
+        if (zone == null) {
+            missing.add(zoneId)
+        } else {
+            zones[i] = zone
+        }
+    }
+    if (missing.isNotEmpty()) memScoped {
+        val names = allocArray<CPointerVar<ByteVar>>(missing.size)
+        missing.forEachIndexed { i, name -> names[i] = name.cstr.getPointer(this) }
+        val ids = allocArray<TZIDVar>(missing.size)
+        timezones_by_names(names, missing.size.convert(), ids)
+        missing.forEachIndexed { i, name ->
+            if (ids[i] == TZID_INVALID) {
+                throw IllegalTimeZoneException("No timezone found with zone ID '$name'")
+            }
+            regionTimeZonesByName.put(name, RegionTimeZone(ids[i], name))
+        }
+    }
+    return List(zoneIds.size) { zones[it] ?: regionTimeZonesByName[zoneIds[it]]!! }
+}
+
+/**
+ * Returns the region-based time zones whose offset from UTC was [offset] at [instant].
+ *
+ * This is much faster than checking the offset of each zone in [TimeZone.availableZoneIds].
+ */
+public fun TimeZone.Companion.zonesWithOffset(offset: UtcOffset, instant: Instant): List<TimeZone> =
+    zonesWithOffset(offset, instant.epochSeconds, instant.epochSeconds + 1)
+
+/**
+ * Returns the region-based time zones whose offset from UTC was [offset] at some moment in [[from]; [until]).
+ */
+public fun TimeZone.Companion.zonesWithOffset(offset: UtcOffset, from: Instant, until: Instant): List<TimeZone> =
+    zonesWithOffset(offset, from.epochSeconds,
+        if (until.nanosecondsOfSecond > 0) until.epochSeconds + 1 else until.epochSeconds)
+
+private fun zonesWithOffset(offset: UtcOffset, fromSeconds: Long, untilSeconds: Long): List<TimeZone> = memScoped {
+    val count = alloc<size_tVar>()
+    val zones = zones_with_offset(offset.totalSeconds, fromSeconds, untilSeconds, count.ptr)
+        ?: throw RuntimeException("Unable to find the zones with offset $offset")
+    zones.toTimeZones(count.value.toInt())
+}
+
+/**
+ * Returns the region-based time zones whose offset from UTC was `offsets[i]` at `instants[i]` for each `i`.
+ *
+ * If no observations are given, all the region-based time zones are returned.
+ */
+public fun TimeZone.Companion.zonesConsistentWith(instants: List<Instant>, offsets: List<UtcOffset>): List<TimeZone> {
+    require(instants.size == offsets.size) {
+        "Expected an offset for each of the ${instants.size} instants, got ${offsets.size} offsets"
+    }
+    return zonesConsistentWith(
+        LongArray(instants.size) { instants[it].epochSeconds },
+        IntArray(offsets.size) { offsets[it].totalSeconds },
+        intArrayOf(0, instants.size)
+    ).single()
+}
+
+/**
+ * Finds the region-based time zones consistent with each of many histories of observed offsets at once.
+ *
+ * The history `h` consists of the observations with indices in
+ * [`historyStarts[h]`; `historyStarts[h + 1]`), each stating that the offset from UTC was
+ * `offsetSeconds[i]` seconds at `epochSeconds[i]` seconds since the epoch.
+ * Returns, for each history, the time zones where the offsets were exactly as observed.
+ *
+ * The time zones are matched against an index built once for all of them, so this scales to millions of histories.
+ */
+public fun TimeZone.Companion.zonesConsistentWith(
+    epochSeconds: LongArray, offsetSeconds: IntArray, historyStarts: IntArray
+): List<List<TimeZone>> {
+    require(epochSeconds.size == offsetSeconds.size) {
+        "Expected an offset for each of the ${epochSeconds.size} instants, got ${offsetSeconds.size} offsets"
+    }
+    require(historyStarts.isNotEmpty() && historyStarts.first() == 0 && historyStarts.last() == epochSeconds.size) {
+        "The histories must cover the observations from 0 to ${epochSeconds.size}"
+    }
+    for (i in 1 until historyStarts.size) {
+        require(historyStarts[i - 1] <= historyStarts[i]) { "The starts of the histories must not decrease" }
+    }
+    val historyCount = historyStarts.size - 1
+    return memScoped {
+        val starts = allocArray<size_tVar>(historyStarts.size)
+        historyStarts.forEachIndexed { i, start -> starts[i] = start.convert() }
+        val zoneStarts = allocArray<size_tVar>(historyStarts.size)
+        // `addressOf(0)` is not allowed for empty arrays.
+        val instants = epochSeconds.copyOf(maxOf(epochSeconds.size, 1))
+        val offsets = offsetSeconds.copyOf(maxOf(offsetSeconds.size, 1))
+        val zones = instants.usePinned { pinnedInstants ->
+            offsets.usePinned { pinnedOffsets ->
+                infer_zones(pinnedInstants.addressOf(0), pinnedOffsets.addressOf(0), starts,
+                    historyCount.convert(), zoneStarts)
+            }
+        } ?: throw RuntimeException("Unable to infer the time zones")
+        try {
+            val cache = HashMap<TZID, TimeZone>()
+            List(historyCount) { h ->
+                val from = zoneStarts[h].toInt()
+                val until = zoneStarts[h + 1].toInt()
+                List(until - from) { i ->
+                    val tzid = zones[from + i]
+                    cache.getOrPut(tzid) { regionTimeZoneById(tzid) }
+                }
+            }
+        } finally {
+            free(zones)
+        }
+    }
+}
+
+/**
+ * Partitions [zones] into classes of time zones whose offsets from UTC are the same at each moment in
+ * [[from]; [until]), so that anything computed from the offsets in that range can be shared within a class.
+ *
+ * If [zones] is `null`, all the region-based time zones are partitioned.
+ * The classes are ordered by their first time zones, and the time zones in each class keep the order of
+ * the native time zone ids; duplicate time zones are reported once.
+ *
+ * @throws IllegalArgumentException if some of [zones] is not a region-based time zone.
+ */
+public fun TimeZone.Companion.equivalenceClasses(
+    from: Instant, until: Instant, zones: Collection<TimeZone>? = null
+): List<List<TimeZone>> = memScoped {
+    val ids = zones?.let { list ->
+        val ids = allocArray<TZIDVar>(maxOf(list.size, 1))
+        list.forEachIndexed { i, zone ->
+            require(zone is RegionTimeZone) { "Only region-based time zones can be partitioned, got $zone" }
+            ids[i] = zone.tzid
+        }
+        ids
+    }
+    val untilSeconds = if (until.nanosecondsOfSecond > 0) until.epochSeconds + 1 else until.epochSeconds
+    val classes = alloc<zone_classes>()
+    if (!zone_equivalence_classes(ids, (zones?.size ?: 0).convert(), from.epochSeconds, untilSeconds, classes.ptr)) {
+        throw RuntimeException("Unable to partition the time zones into equivalence classes")
+    }
+    try {
+        val byId = zones?.associateBy { (it as RegionTimeZone).tzid }
+        List(classes.class_count.toInt()) { c ->
+            val start = classes.class_starts!![c].toInt()
+            val end = classes.class_starts!![c + 1].toInt()
+            List(end - start) { i ->
+                val tzid = classes.zones!![start + i]
+                byId?.get(tzid) ?: regionTimeZoneById(tzid)
+            }
+        }
+    } finally {
+        zone_classes_free(classes.ptr)
+    }
+}
+
+/**
+ * Returns the abbreviation used in this time zone at [instant], like `CEST`.
+ *
+ * Where the platform doesn't provide abbreviations, the offset is written instead, like `+0530`.
+ * For time zones with a fixed offset, their [TimeZone.id] is returned.
+ */
+public fun TimeZone.abbreviationAt(instant: Instant): String = when (this) {
+    is RegionTimeZone -> abbreviation_at_instant(tzid, instant.epochSeconds)?.toKString()
+        ?: throw RuntimeException("Unable to acquire the abbreviation at instant $instant for zone $this")
+    else -> id
+}
+
+/**
+ * Returns the region-based time zones that used [abbreviation] at some moment in [[from]; [until]).
+ *
+ * Abbreviations are ambiguous: for example, `IST` is used both in India and in Ireland.
+ */
+public fun TimeZone.Companion.zonesWithAbbreviation(abbreviation: String, from: Instant, until: Instant): List<TimeZone> =
+    memScoped {
+        val untilSeconds = if (until.nanosecondsOfSecond > 0) until.epochSeconds + 1 else until.epochSeconds
+        val count = alloc<size_tVar>()
+        val zones = zones_with_abbreviation(abbreviation, from.epochSeconds, untilSeconds, count.ptr)
+            ?: throw RuntimeException("Unable to find the zones with abbreviation $abbreviation")
+        zones.toTimeZones(count.value.toInt())
+    }
+
+/**
+ * Returns the region-based time zones whose ids have a word starting with [prefix], for example, to suggest
+ * the time zones while their ids are being typed.
+ *
+ * The words start at the beginning of the id and after each `/`, `_`, or `-`, so both `"new_y"` and `"york"` find
+ * `America/New_York` if [ignoreCase] is `true`. The ids are indexed once, so this is much faster than filtering
+ * [TimeZone.availableZoneIds].
+ */
+public fun TimeZone.Companion.zonesWithIdPrefix(prefix: String, ignoreCase: Boolean = true): List<TimeZone> =
+    memScoped {
+        val count = alloc<size_tVar>()
+        val zones = zones_with_name_prefix(prefix, ignoreCase, count.ptr)
+            ?: throw RuntimeException("Unable to find the zones with prefix $prefix")
+        zones.toTimeZones(count.value.toInt())
+    }
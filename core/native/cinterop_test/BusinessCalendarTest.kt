@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class BusinessCalendarTest {
+
+    private fun slowPlusWorkingDays(calendar: BusinessCalendar, date: LocalDate, workingDays: Int): LocalDate {
+        var result = date
+        var left = workingDays
+        val step = if (workingDays > 0) 1 else -1
+        while (left != 0) {
+            result = result.plus(step, DateTimeUnit.DAY)
+            if (calendar.isWorkingDay(result)) left -= step
+        }
+        return result
+    }
+
+    @Test
+    fun weekdaysAndHolidays() {
+        val calendar = BusinessCalendar()
+        try {
+            calendar.markHolidays(listOf(LocalDate(2021, 12, 24), LocalDate(2021, 12, 31)))
+            calendar.markWorkingDays(listOf(LocalDate(2022, 1, 1)))
+            assertTrue(calendar.isWorkingDay(LocalDate(2021, 12, 23)))
+            assertFalse(calendar.isWorkingDay(LocalDate(2021, 12, 24)))
+            assertFalse(calendar.isWorkingDay(LocalDate(2021, 12, 25)))
+            assertTrue(calendar.isWorkingDay(LocalDate(2022, 1, 1)))
+            assertEquals(LocalDate(2021, 12, 27), calendar.nextWorkingDay(LocalDate(2021, 12, 24)))
+            assertEquals(LocalDate(2021, 12, 23), calendar.nextWorkingDay(LocalDate(2021, 12, 23)))
+            assertEquals(LocalDate(2021, 12, 27), calendar.plusWorkingDays(LocalDate(2021, 12, 23), 1))
+            assertEquals(LocalDate(2022, 1, 1), calendar.plusWorkingDays(LocalDate(2021, 12, 30), 1))
+            assertEquals(LocalDate(2021, 12, 23), calendar.plusWorkingDays(LocalDate(2021, 12, 27), -1))
+            assertEquals(LocalDate(2021, 12, 25), calendar.plusWorkingDays(LocalDate(2021, 12, 25), 0))
+            assertEquals(5, calendar.workingDaysBetween(LocalDate(2021, 12, 23), LocalDate(2021, 12, 31)))
+            assertEquals(-5, calendar.workingDaysBetween(LocalDate(2021, 12, 31), LocalDate(2021, 12, 23)))
+            val start = LocalDate(2021, 12, 1)
+            for (days in -40..40) {
+                assertEquals(slowPlusWorkingDays(calendar, start, days), calendar.plusWorkingDays(start, days))
+            }
+        } finally {
+            calendar.close()
+        }
+    }
+
+    @Test
+    fun epochDays() {
+        val calendar = BusinessCalendar(setOf(DayOfWeek.SATURDAY, DayOfWeek.SUNDAY))
+        try {
+            // 1970-01-01 was a Thursday.
+            assertContentEquals(
+                intArrayOf(2, 9, -4),
+                calendar.plusWorkingDays(intArrayOf(0, 0, 0), intArrayOf(1, 3, -1))
+            )
+            assertContentEquals(intArrayOf(2, 0), calendar.workingDaysBetween(intArrayOf(0, 2), intArrayOf(7, 2)))
+            assertContentEquals(intArrayOf(), calendar.plusWorkingDays(intArrayOf(), intArrayOf()))
+        } finally {
+            calendar.close()
+        }
+    }
+
+    @Test
+    fun noWorkingDays() {
+        val calendar = BusinessCalendar(emptySet())
+        try {
+            assertFailsWith<DateTimeArithmeticException> { calendar.nextWorkingDay(LocalDate(2021, 1, 1)) }
+            calendar.markWorkingDays(listOf(LocalDate(2021, 6, 1)))
+            assertEquals(LocalDate(2021, 6, 1), calendar.plusWorkingDays(LocalDate(2021, 1, 1), 1))
+            assertFailsWith<DateTimeArithmeticException> { calendar.plusWorkingDays(LocalDate(2021, 1, 1), 2) }
+        } finally {
+            calendar.close()
+        }
+    }
+
+    @Test
+    fun farApartDays() {
+        val calendar = BusinessCalendar()
+        val plain = BusinessCalendar()
+        try {
+            val holidays = listOf(LocalDate(-999999, 1, 1), LocalDate(999999, 1, 1), LocalDate(2021, 12, 24))
+            calendar.markHolidays(holidays)
+            val weekdayHolidays = holidays.count { plain.isWorkingDay(it) }
+            for (holiday in holidays) {
+                assertFalse(calendar.isWorkingDay(holiday))
+                assertEquals(slowPlusWorkingDays(calendar, holiday, 3), calendar.plusWorkingDays(holiday, 3))
+            }
+            val from = LocalDate(-999999, 1, 1)
+            val until = LocalDate(999999, 1, 2)
+            assertEquals(plain.workingDaysBetween(from, until) - weekdayHolidays, calendar.workingDaysBetween(from, until))
+        } finally {
+            calendar.close()
+            plain.close()
+        }
+    }
+}
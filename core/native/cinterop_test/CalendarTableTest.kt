@@ -0,0 +1,41 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class CalendarTableTest {
+    @Test
+    fun columns() {
+        val from = LocalDate(1999, 12, 27)
+        val until = LocalDate(2031, 1, 1)
+        val zones = listOf(TimeZone.of("Europe/Berlin"), TimeZone.of("America/Sao_Paulo"), TimeZone.of("UTC+3"))
+        val table = CalendarTable(from, until, zones)
+        assertEquals(from.daysUntil(until), table.size)
+        for (i in 0 until table.size) {
+            val date = from.plus(i, DateTimeUnit.DAY)
+            assertEquals(date, LocalDate(table.years[i], table.months[i], table.daysOfMonth[i]))
+            assertEquals(date.dayOfWeek.isoDayNumber, table.daysOfWeek[i])
+            assertEquals(date.dayOfYear, table.daysOfYear[i])
+            assertEquals(IsoWeekDate.weekBasedYear(date), table.weekBasedYears[i])
+            assertEquals(IsoWeekDate.weekOfWeekBasedYear(date), table.weeks[i])
+            assertEquals((date.monthNumber + 2) / 3, table.quarters[i])
+            zones.forEachIndexed { z, zone ->
+                assertEquals(date.atStartOfDayIn(zone), table.startOfDay(z, i))
+            }
+        }
+        val winter = from.daysUntil(LocalDate(2021, 1, 15))
+        val summer = from.daysUntil(LocalDate(2021, 7, 15))
+        assertFalse(table.daylightSaving[winter])
+        assertTrue(table.daylightSaving[summer])
+        assertTrue(table.daylightSaving[table.size + from.daysUntil(LocalDate(2017, 1, 15))])
+        assertFalse(table.daylightSaving[table.size + summer])
+        assertFalse(table.daylightSaving[2 * table.size + summer])
+        assertEquals(0, CalendarTable(from, from, zones).size)
+        assertFailsWith<IllegalArgumentException> { CalendarTable(until, from, zones) }
+    }
+}
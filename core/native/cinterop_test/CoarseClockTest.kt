@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+import kotlin.time.*
+
+class CoarseClockTest {
+    @OptIn(ExperimentalTime::class)
+    @Test
+    fun followsTheSystemClock() {
+        assertFailsWith<IllegalArgumentException> { CoarseClock.start(0) }
+        CoarseClock.start(500)
+        try {
+            assertTrue(CoarseClock.isRunning)
+            // Changing the tick of the running clock.
+            CoarseClock.start(1000)
+            val system = Clock.System.now()
+            val coarse = CoarseClock.now()
+            // Generous bounds, as the ticker thread may not be scheduled in time.
+            assertTrue(system - coarse < Duration.seconds(1), "$coarse is too far behind $system")
+            assertTrue(coarse <= Clock.System.now())
+            assertTrue(CoarseClock.now() >= coarse)
+        } finally {
+            CoarseClock.stop()
+        }
+        assertFalse(CoarseClock.isRunning)
+        // The system clock is read directly while the clock is stopped.
+        val before = Clock.System.now()
+        assertTrue(CoarseClock.now() >= before)
+    }
+}
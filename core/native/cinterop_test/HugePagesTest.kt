@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.cinterop.*
+import kotlinx.datetime.*
+import kotlinx.datetime.internal.*
+import platform.posix.*
+import kotlin.test.*
+
+class HugePagesTest {
+    @Test
+    fun reportedHugePagesAreMapped() {
+        val huge = zone_tables_use_huge_pages(true)
+        try {
+            val (firstChunk, allocatedBefore) = tablesArena()
+            assertNotEquals(0L, firstChunk, "The first chunk of the arena was not mapped")
+            // Classifying goes through the compiled tables, so the ones that are not computed yet are built in the arena.
+            val dateTime = LocalDateTime(2021, 7, 1, 12, 0)
+            for (id in TimeZone.availableZoneIds) {
+                val zone = TimeZone.of(id)
+                val result = zone.classifyLocalDateTimes(listOf(dateTime))
+                if (result.kind(0) == LocalDateTimeKind.UNIQUE) {
+                    assertEquals(zone.offsetAt(dateTime.toInstant(zone)), result.validOffsets(0).single(), id)
+                }
+            }
+            val (firstChunkAfter, allocatedAfter) = tablesArena()
+            assertEquals(firstChunk, firstChunkAfter)
+            // The tables computed by the earlier tests stay where they are.
+            assertTrue(allocatedAfter >= allocatedBefore)
+            val mapping = memoryMappings()?.firstOrNull { firstChunk.toULong() in it.range }
+            if (mapping == null) {
+                // Not Linux, so the tables are in ordinary memory.
+                assertFalse(huge)
+            } else {
+                // Either reserved huge pages or a range advised to be backed by transparent ones.
+                val hugeMapping = mapping.lines.any { it.startsWith("KernelPageSize:") && it.split(Regex("\\s+"))[1] != "4" } ||
+                    mapping.lines.any { it.startsWith("VmFlags:") && " hg" in it }
+                assertEquals(hugeMapping, huge, "The reported use of huge pages doesn't match the mapping of the arena")
+            }
+        } finally {
+            assertFalse(zone_tables_use_huge_pages(false))
+        }
+        assertFalse(memScoped { zone_tables_arena(alloc<COpaquePointerVar>().ptr, alloc<size_tVar>().ptr) })
+    }
+}
+
+// The address of the first chunk of the arena of the zone tables and the number of bytes allocated from it.
+private fun tablesArena(): Pair<Long, Long> = memScoped {
+    val firstChunk = alloc<COpaquePointerVar>()
+    val allocated = alloc<size_tVar>()
+    assertTrue(zone_tables_arena(firstChunk.ptr, allocated.ptr), "The zone tables are not packed")
+    Pair(firstChunk.value.toLong(), allocated.value.toLong())
+}
+
+private class MemoryMapping(val range: ULongRange, val lines: MutableList<String>)
+
+// The mappings of the process described in `/proc/self/smaps`, or `null` if there's no such file.
+private fun memoryMappings(): List<MemoryMapping>? {
+    val file = fopen("/proc/self/smaps", "r") ?: return null
+    val mappings = mutableListOf<MemoryMapping>()
+    val header = Regex("^([0-9a-f]+)-([0-9a-f]+) ")
+    try {
+        memScoped {
+            val buffer = allocArray<ByteVar>(1024)
+            while (fgets(buffer, 1024, file) != null) {
+                val line = buffer.toKString().trimEnd()
+                val bounds = header.find(line)
+                if (bounds != null) {
+                    val (begin, end) = bounds.destructured
+                    mappings.add(MemoryMapping(begin.toULong(16) until end.toULong(16), mutableListOf()))
+                }
+                mappings.lastOrNull()?.lines?.add(line)
+            }
+        }
+    } finally {
+        fclose(file)
+    }
+    return mappings
+}
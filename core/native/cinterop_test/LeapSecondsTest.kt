@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class LeapSecondsTest {
+
+    @Test
+    fun conversions() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no system table of leap seconds there
+        val utc = listOf(
+            LocalDateTime(1970, 1, 1, 0, 0),
+            LocalDateTime(1972, 6, 30, 23, 59, 59),
+            LocalDateTime(1972, 7, 1, 0, 0),
+            LocalDateTime(2016, 12, 31, 23, 59, 59),
+            LocalDateTime(2017, 1, 1, 0, 0),
+            LocalDateTime(2021, 6, 1, 0, 0),
+        ).map { it.toInstant(TimeZone.UTC).epochSeconds }.toLongArray()
+        val tai = LeapSeconds.utcToTai(utc)
+        assertContentEquals(longArrayOf(10, 10, 11, 36, 37, 37), LongArray(utc.size) { tai[it] - utc[it] })
+        assertContentEquals(utc, LeapSeconds.taiToUtc(tai))
+        // the leap second at the end of 2016 maps to the next second
+        assertContentEquals(longArrayOf(utc[4]), LeapSeconds.taiToUtc(longArrayOf(tai[3] + 1)))
+        assertContentEquals(longArrayOf(), LeapSeconds.utcToTai(longArrayOf()))
+    }
+
+    @Test
+    fun taiNow() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no system table of leap seconds there
+        val difference = LeapSeconds.taiNow().epochSeconds - Clock.System.now().epochSeconds
+        assertTrue(difference in 36..38, "TAI - UTC is $difference")
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class LocalDateTimeClassificationTest {
+    @Test
+    fun gapsAndOverlaps() {
+        val berlin = TimeZone.of("Europe/Berlin")
+        val dateTimes = listOf(
+            LocalDateTime(2021, 3, 28, 1, 59, 59),
+            // The clocks are moved from 02:00 to 03:00.
+            LocalDateTime(2021, 3, 28, 2, 0),
+            LocalDateTime(2021, 3, 28, 2, 59, 59),
+            LocalDateTime(2021, 3, 28, 3, 0),
+            // The clocks are moved from 03:00 to 02:00.
+            LocalDateTime(2021, 10, 31, 1, 59, 59),
+            LocalDateTime(2021, 10, 31, 2, 30),
+            LocalDateTime(2021, 10, 31, 3, 0),
+        )
+        val expectedKinds = listOf(LocalDateTimeKind.UNIQUE, LocalDateTimeKind.GAP, LocalDateTimeKind.GAP,
+            LocalDateTimeKind.UNIQUE, LocalDateTimeKind.UNIQUE, LocalDateTimeKind.OVERLAP, LocalDateTimeKind.UNIQUE)
+        for (input in listOf(dateTimes, dateTimes.reversed())) {
+            val result = berlin.classifyLocalDateTimes(input)
+            assertEquals(input.size, result.size)
+            val kinds = if (input === dateTimes) expectedKinds else expectedKinds.reversed()
+            assertEquals(kinds, input.indices.map { result.kind(it) })
+        }
+        val result = berlin.classifyLocalDateTimes(dateTimes)
+        assertContentEquals(intArrayOf(3600, 3600, 3600, 7200, 7200, 7200, 3600), result.offsetsBefore)
+        assertContentEquals(intArrayOf(3600, 7200, 7200, 7200, 7200, 3600, 3600), result.offsetsAfter)
+        assertEquals(emptyList<UtcOffset>(), result.validOffsets(1))
+        assertEquals(listOf(UtcOffset(hours = 2), UtcOffset(hours = 1)), result.validOffsets(5))
+        assertEquals(listOf(UtcOffset(hours = 1)), result.validOffsets(6))
+        // The offsets agree with the conversions of the unique date-times.
+        for (i in dateTimes.indices.filter { result.kind(it) == LocalDateTimeKind.UNIQUE }) {
+            assertEquals(result.validOffsets(i).single(), berlin.offsetAt(dateTimes[i].toInstant(berlin)))
+        }
+        val fixed = TimeZone.of("UTC+3").classifyLocalDateTimes(dateTimes)
+        assertContentEquals(IntArray(dateTimes.size) { 10800 }, fixed.offsetsAfter)
+        assertEquals(0, berlin.classifyLocalDateTimes(longArrayOf()).size)
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class LocalTimeUntilTest {
+    @Test
+    fun aroundTransitions() {
+        val berlin = TimeZone.of("Europe/Berlin")
+        val offset = TimeZone.of("UTC+3")
+        val zones = listOf(berlin, berlin, offset, offset)
+        val times = listOf(LocalTime(2, 30), LocalTime(1, 0), LocalTime(3, 30), LocalTime(3, 0))
+        // 01:30 in Berlin, just before the clocks are moved from 02:00 to 03:00.
+        val spring = Instant.parse("2021-03-28T00:30:00Z")
+        // 02:30 is skipped and moved forward to 03:30, in an hour; 01:00 is next seen the next day, and this day is an
+        // hour shorter.
+        assertContentEquals(longArrayOf(3600, 81000, 0, 86400 - 1800),
+            TimeZone.secondsUntilNext(zones, times, spring))
+        // The same as converting the skipped date-time to an instant.
+        val skipped = LocalDateTime(2021, 3, 28, 2, 30).toInstant(berlin)
+        assertEquals(skipped.epochSeconds - spring.epochSeconds, TimeZone.secondsUntilNext(zones, times, spring)[0])
+        // 02:45 in Berlin for the first time, before the clocks are moved from 03:00 to 02:00.
+        val autumn = Instant.parse("2021-10-31T00:45:00Z")
+        assertEquals(2700L, TimeZone.secondsUntilNext(listOf(berlin), listOf(LocalTime(2, 30)), autumn)[0])
+        assertEquals(83700L, TimeZone.secondsUntilNext(listOf(berlin), listOf(LocalTime(1, 0)), autumn)[0])
+        // A day can be up to 25 hours long.
+        assertTrue(berlin.secondsUntilNext(LocalTime(0, 0)) in 0L until 25L * 3600)
+        assertFailsWith<IllegalArgumentException> { TimeZone.secondsUntilNext(zones, times.take(1)) }
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+import kotlin.time.*
+
+@OptIn(ExperimentalTime::class)
+class LocalTimerWheelTest {
+
+    @Test
+    fun firesAtLocalTimes() {
+        val berlin = TimeZone.of("Europe/Berlin")
+        val newYork = TimeZone.of("America/New_York")
+        val start = LocalDateTime(2021, 3, 27, 0, 0).toInstant(TimeZone.UTC)
+        val wheel = LocalTimerWheel(start)
+        try {
+            val midnight = LocalDateTime(2021, 3, 28, 0, 0)
+            wheel.schedule(midnight, berlin, 1)
+            wheel.schedule(midnight, newYork, 2)
+            wheel.schedule(LocalDateTime(2021, 3, 28, 2, 30), berlin, 3) // in the gap
+            val cancelled = wheel.schedule(midnight, TimeZone.UTC, 4)
+            assertEquals(4, wheel.size)
+            assertTrue(wheel.cancel(cancelled))
+            assertFalse(wheel.cancel(cancelled))
+            assertContentEquals(longArrayOf(), wheel.advance(midnight.toInstant(berlin) - Duration.seconds(1)))
+            assertContentEquals(longArrayOf(1), wheel.advance(midnight.toInstant(berlin)))
+            assertContentEquals(longArrayOf(), wheel.advance(LocalDateTime(2021, 3, 28, 2, 59, 59).toInstant(berlin)))
+            assertContentEquals(longArrayOf(3), wheel.advance(LocalDateTime(2021, 3, 28, 3, 0).toInstant(berlin)))
+            assertContentEquals(longArrayOf(2), wheel.advance(midnight.toInstant(newYork)))
+            assertEquals(0, wheel.size)
+        } finally {
+            wheel.close()
+        }
+    }
+
+    @Test
+    fun repeats() {
+        val zone = TimeZone.of("Europe/Berlin")
+        val wheel = LocalTimerWheel(LocalDateTime(2021, 3, 25, 0, 0).toInstant(zone))
+        try {
+            wheel.schedule(LocalDateTime(2021, 3, 26, 8, 0), zone, 42, repeatDays = 1)
+            for (day in 26..31) {
+                val time = LocalDateTime(2021, 3, day, 8, 0).toInstant(zone)
+                assertContentEquals(longArrayOf(), wheel.advance(time - Duration.seconds(1)))
+                assertContentEquals(longArrayOf(42), wheel.advance(time))
+            }
+            assertEquals(1, wheel.size)
+        } finally {
+            wheel.close()
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlinx.datetime.internal.*
+import kotlin.test.*
+
+class OffsetIntervalCacheTest {
+    @Test
+    fun hitsAndMisses() {
+        // A cache of its own, so that the lookups made by the other tests through the shared time zones don't count.
+        val cache = OffsetIntervalCache(timezone_by_name("Europe/Vilnius"))
+        val summer = Instant.parse("2021-07-01T00:00:00Z").epochSeconds
+        val winter = Instant.parse("2021-12-01T00:00:00Z").epochSeconds
+        OffsetCacheStatistics.enabled = true
+        try {
+            assertEquals(UtcOffset(hours = 3), cache.offsetAt(summer))
+            for (hour in 1..100) {
+                assertEquals(UtcOffset(hours = 3), cache.offsetAt(summer + hour * 3600))
+            }
+            assertEquals(UtcOffset(hours = 2), cache.offsetAt(winter))
+            assertEquals(UtcOffset(hours = 2), cache.offsetAt(winter))
+            assertEquals(UtcOffset(hours = 3), cache.offsetAt(summer))
+            assertEquals(OffsetCacheStatistics(hits = 102, misses = 2), cache.statistics())
+        } finally {
+            OffsetCacheStatistics.enabled = false
+        }
+        // The lookups are not counted unless the statistics are enabled.
+        cache.offsetAt(summer)
+        assertEquals(102L, cache.statistics().hits)
+        // The offsets right at the transitions.
+        val transition = Instant.parse("2021-10-31T01:00:00Z").epochSeconds
+        assertEquals(UtcOffset(hours = 2), cache.offsetAt(transition))
+        assertEquals(UtcOffset(hours = 3), cache.offsetAt(transition - 1))
+        val zone = TimeZone.of("Europe/Vilnius")
+        assertEquals(LocalDateTime(2021, 12, 1, 2, 0), Instant.fromEpochSeconds(winter).toLocalDateTime(zone))
+        assertEquals(OffsetCacheStatistics(0, 0), TimeZone.UTC.offsetCacheStatistics())
+    }
+}
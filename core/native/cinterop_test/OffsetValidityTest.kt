@@ -0,0 +1,28 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.cinterop.*
+import kotlinx.datetime.internal.*
+import kotlin.test.*
+
+class OffsetValidityTest {
+    @Test
+    fun intervalAroundInstant() = memScoped {
+        val zone = timezone_by_name("Europe/Berlin")
+        val from = alloc<LongVar>()
+        val until = alloc<LongVar>()
+        // 2021-07-01T00:00:00Z, between the transitions of 2021-03-28T01:00:00Z and 2021-10-31T01:00:00Z.
+        val instant = 1625097600L
+        assertEquals(7200, offset_at_instant_with_validity(zone, instant, from.ptr, until.ptr))
+        assertEquals(1616893200L, from.value)
+        assertEquals(1635642000L, until.value)
+        assertEquals(7200, offset_at_instant(zone, from.value))
+        assertEquals(7200, offset_at_instant(zone, until.value - 1))
+        assertEquals(3600, offset_at_instant(zone, until.value))
+        assertEquals(Int.MAX_VALUE, offset_at_instant_with_validity(TZID_INVALID, instant, from.ptr, until.ptr))
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class RecurrenceTest {
+
+    private fun LongArray.toLocal(zone: TimeZone) = map { Instant.fromEpochSeconds(it).toLocalDateTime(zone) }
+
+    @Test
+    fun weekdays() {
+        val zone = TimeZone.of("Europe/Berlin")
+        val rule = RecurrenceRule.weekly(LocalDate(2021, 3, 1),
+            setOf(DayOfWeek.MONDAY, DayOfWeek.TUESDAY, DayOfWeek.WEDNESDAY, DayOfWeek.THURSDAY, DayOfWeek.FRIDAY), 9, 0)
+        val from = LocalDateTime(2021, 3, 26, 0, 0).toInstant(zone)
+        val until = LocalDateTime(2021, 3, 31, 0, 0).toInstant(zone)
+        val instants = zone.recurrenceInstants(rule, from, until)
+        assertEquals(listOf(26, 29, 30).map { LocalDateTime(2021, 3, it, 9, 0) }, instants.toLocal(zone))
+    }
+
+    @Test
+    fun gapsAndOverlaps() {
+        val zone = TimeZone.of("Europe/Berlin")
+        val rule = RecurrenceRule.daily(LocalDate(2021, 1, 1), 2, 30)
+        val springFrom = LocalDateTime(2021, 3, 27, 0, 0).toInstant(zone)
+        val springUntil = LocalDateTime(2021, 3, 29, 0, 0).toInstant(zone)
+        assertEquals(
+            listOf(LocalDateTime(2021, 3, 27, 2, 30), LocalDateTime(2021, 3, 28, 3, 30)),
+            zone.recurrenceInstants(rule, springFrom, springUntil).toLocal(zone))
+        assertEquals(
+            listOf(LocalDateTime(2021, 3, 27, 2, 30), LocalDateTime(2021, 3, 28, 3, 0)),
+            zone.recurrenceInstants(rule, springFrom, springUntil, GapHandling.NEXT_CORRECT).toLocal(zone))
+        assertEquals(1, zone.recurrenceInstants(rule, springFrom, springUntil, GapHandling.SKIP).size)
+        val autumnFrom = LocalDateTime(2021, 10, 31, 0, 0).toInstant(zone)
+        val autumnUntil = LocalDateTime(2021, 11, 1, 0, 0).toInstant(zone)
+        val earlier = zone.recurrenceInstants(rule, autumnFrom, autumnUntil, overlapHandling = OverlapHandling.EARLIER)
+        val later = zone.recurrenceInstants(rule, autumnFrom, autumnUntil, overlapHandling = OverlapHandling.LATER)
+        val both = zone.recurrenceInstants(rule, autumnFrom, autumnUntil, overlapHandling = OverlapHandling.BOTH)
+        assertEquals(3600, later.single() - earlier.single())
+        assertContentEquals(earlier + later, both)
+    }
+
+    @Test
+    fun monthly() {
+        val zone = TimeZone.of("America/New_York")
+        val from = LocalDateTime(2021, 1, 1, 0, 0).toInstant(zone)
+        val until = LocalDateTime(2022, 1, 1, 0, 0).toInstant(zone)
+        val lastDays = zone.recurrenceInstants(RecurrenceRule.monthly(LocalDate(2020, 1, 1), -1, 18, 30), from, until)
+        assertEquals(12, lastDays.size)
+        assertEquals(LocalDateTime(2021, 2, 28, 18, 30), lastDays.toLocal(zone)[1])
+        val thirtyFirsts = zone.recurrenceInstants(
+            RecurrenceRule.monthly(LocalDate(2020, 1, 1), 31, 12, 0, interval = 2), from, until)
+        assertEquals(listOf(1, 3, 5, 7), thirtyFirsts.toLocal(zone).map { it.monthNumber })
+    }
+
+    @Test
+    fun fixedOffset() {
+        val zone = TimeZone.of("+05:30")
+        val rule = RecurrenceRule.daily(LocalDate(2021, 1, 1), 0, 0, interval = 3)
+        val instants = zone.recurrenceInstants(rule,
+            LocalDateTime(2020, 12, 1, 0, 0).toInstant(zone), LocalDateTime(2021, 1, 10, 0, 0).toInstant(zone))
+        assertEquals(listOf(1, 4, 7), instants.toLocal(zone).map { it.dayOfMonth })
+    }
+
+    @Test
+    fun invalidRules() {
+        assertFailsWith<IllegalArgumentException> { RecurrenceRule.daily(LocalDate(2021, 1, 1), 24, 0) }
+        assertFailsWith<IllegalArgumentException> { RecurrenceRule.weekly(LocalDate(2021, 1, 1), emptySet(), 0, 0) }
+        assertFailsWith<IllegalArgumentException> { RecurrenceRule.monthly(LocalDate(2021, 1, 1), 0, 0, 0) }
+        assertFailsWith<IllegalArgumentException> { RecurrenceRule.daily(LocalDate(100000, 1, 1), 0, 0) }
+    }
+
+    @Test
+    fun extremeRanges() {
+        val zone = TimeZone.of("Europe/Berlin")
+        // The occurrences are only computed up to the end of the year 32767.
+        val yearly = RecurrenceRule.monthly(LocalDate(2021, 1, 1), 1, 12, 0, interval = 12)
+        val instants = zone.recurrenceInstants(yearly, Instant.DISTANT_PAST, Instant.DISTANT_FUTURE)
+        assertEquals(32767 - 2021 + 1, instants.size)
+        assertEquals(LocalDateTime(32767, 1, 1, 12, 0), Instant.fromEpochSeconds(instants.last()).toLocalDateTime(zone))
+        // The last supported day is included.
+        val lastDays = RecurrenceRule.monthly(LocalDate(32767, 1, 1), -1, 12, 0)
+        val ends = zone.recurrenceInstants(lastDays, Instant.DISTANT_PAST, Instant.DISTANT_FUTURE)
+        assertEquals(12, ends.size)
+        assertEquals(LocalDateTime(32767, 12, 31, 12, 0), Instant.fromEpochSeconds(ends.last()).toLocalDateTime(zone))
+        // Too many occurrences.
+        val daily = RecurrenceRule.daily(LocalDate(2021, 1, 1), 12, 0)
+        assertFailsWith<RuntimeException> {
+            zone.recurrenceInstants(daily, Instant.DISTANT_PAST, Instant.DISTANT_FUTURE)
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class TimeZoneDatabaseTest {
+
+    private val directory = "/usr/share/zoneinfo"
+
+    @Test
+    fun sameRulesAsSystem() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no TZif files there
+        val database = TimeZoneDatabase.load(directory)
+        assertTrue("Europe/Berlin" in database.availableZoneIds)
+        val berlin = database.zone("Europe/Berlin")
+        val systemBerlin = TimeZone.of("Europe/Berlin")
+        assertEquals("Europe/Berlin", berlin.id)
+        for (month in 1..12) {
+            val dateTime = LocalDateTime(2021, month, 15, 12, 0)
+            assertEquals(dateTime.toInstant(systemBerlin), dateTime.toInstant(berlin))
+            assertEquals(dateTime.toInstant(systemBerlin).offsetIn(systemBerlin), dateTime.toInstant(berlin).offsetIn(berlin))
+        }
+        val gap = LocalDateTime(2021, 3, 28, 2, 30)
+        assertEquals(gap.toInstant(systemBerlin), gap.toInstant(berlin))
+        val santiago = database.zone("America/Santiago")
+        val date = LocalDate(2021, 9, 5) // starts at 01:00
+        assertEquals(date.atStartOfDayIn(TimeZone.of("America/Santiago")), date.atStartOfDayIn(santiago))
+    }
+
+    @Test
+    fun versionsAreSeparate() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no TZif files there
+        val first = TimeZoneDatabase.load(directory)
+        val second = TimeZoneDatabase.load(directory)
+        assertEquals(first.zone("Europe/Paris"), first.zone("Europe/Paris"))
+        assertNotEquals(first.zone("Europe/Paris"), second.zone("Europe/Paris"))
+        // The equality is symmetric, and a versioned time zone is not equal to the one the system provides.
+        val system = TimeZone.of("Europe/Paris")
+        val versioned = first.zone("Europe/Paris")
+        assertNotEquals<TimeZone>(system, versioned)
+        assertNotEquals<TimeZone>(versioned, system)
+        assertEquals(first.zone("Europe/Paris").hashCode(), versioned.hashCode())
+        assertFailsWith<IllegalTimeZoneException> { first.zone("Mars/Olympus_Mons") }
+        assertFailsWith<IllegalArgumentException> { TimeZoneDatabase.load("/nonexistent/directory") }
+    }
+
+    @Test
+    fun noDifferencesBetweenCopies() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no TZif files there
+        val first = TimeZoneDatabase.load(directory)
+        val second = TimeZoneDatabase.load(directory)
+        val from = LocalDateTime(1900, 1, 1, 0, 0).toInstant(TimeZone.UTC)
+        val until = LocalDateTime(2100, 1, 1, 0, 0).toInstant(TimeZone.UTC)
+        assertEquals(listOf(), second.differencesFrom(first, from, until))
+    }
+}
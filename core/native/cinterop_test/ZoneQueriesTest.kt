@@ -0,0 +1,145 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+import kotlin.time.*
+
+@OptIn(ExperimentalTime::class)
+class ZoneQueriesTest {
+
+    @Test
+    fun zonesWithOffset() {
+        val instant = LocalDateTime(2020, 7, 1, 12, 0).toInstant(TimeZone.UTC)
+        val offset = UtcOffset(hours = 5, minutes = 30)
+        val zones = TimeZone.zonesWithOffset(offset, instant)
+        assertTrue(TimeZone.of("Asia/Kolkata") in zones)
+        for (zone in zones) {
+            assertEquals(offset, instant.offsetIn(zone))
+        }
+        val expected = TimeZone.availableZoneIds.map { TimeZone.of(it) }
+            .filter { it !is FixedOffsetTimeZone && instant.offsetIn(it) == offset }
+        assertEquals(expected.map { it.id }.toSet(), zones.map { it.id }.toSet())
+    }
+
+    @Test
+    fun zonesWithOffsetInRange() {
+        val berlin = TimeZone.of("Europe/Berlin")
+        val summer = UtcOffset(hours = 2)
+        val winterFrom = LocalDateTime(2021, 1, 1, 0, 0).toInstant(berlin)
+        val winterUntil = LocalDateTime(2021, 2, 1, 0, 0).toInstant(berlin)
+        assertFalse(berlin in TimeZone.zonesWithOffset(summer, winterFrom, winterUntil))
+        val yearUntil = LocalDateTime(2022, 1, 1, 0, 0).toInstant(berlin)
+        assertTrue(berlin in TimeZone.zonesWithOffset(summer, winterFrom, yearUntil))
+        assertTrue(TimeZone.zonesWithOffset(UtcOffset(hours = 1, minutes = 1, seconds = 1), winterFrom, yearUntil)
+            .isEmpty())
+    }
+
+    @Test
+    fun zonesConsistentWithObservations() {
+        val berlin = TimeZone.of("Europe/Berlin")
+        val winter = LocalDateTime(2021, 1, 15, 12, 0).toInstant(berlin)
+        val summer = LocalDateTime(2021, 7, 15, 12, 0).toInstant(berlin)
+        val zones = TimeZone.zonesConsistentWith(listOf(winter, summer), listOf(UtcOffset(hours = 1), UtcOffset(hours = 2)))
+        assertTrue(berlin in zones)
+        assertFalse(TimeZone.of("Africa/Lagos") in zones) // +01:00 all year
+        for (zone in zones) {
+            assertEquals(UtcOffset(hours = 1), winter.offsetIn(zone))
+            assertEquals(UtcOffset(hours = 2), summer.offsetIn(zone))
+        }
+        assertTrue(TimeZone.zonesConsistentWith(listOf(winter, summer), listOf(UtcOffset(hours = 2), UtcOffset(hours = 1)))
+            .isEmpty())
+    }
+
+    @Test
+    fun zonesConsistentWithManyHistories() {
+        val instant = LocalDateTime(2020, 7, 1, 12, 0).toInstant(TimeZone.UTC)
+        val kolkata = UtcOffset(hours = 5, minutes = 30)
+        val result = TimeZone.zonesConsistentWith(
+            longArrayOf(instant.epochSeconds, instant.epochSeconds, instant.epochSeconds + 3600),
+            intArrayOf(kolkata.totalSeconds, UtcOffset(hours = 1, minutes = 1).totalSeconds, kolkata.totalSeconds),
+            intArrayOf(0, 1, 2, 2, 3))
+        assertEquals(4, result.size)
+        assertEquals(TimeZone.zonesWithOffset(kolkata, instant).toSet(), result[0].toSet())
+        assertTrue(result[1].isEmpty())
+        assertTrue(result[2].size > 1) // no observations
+        assertTrue(TimeZone.of("Asia/Kolkata") in result[3])
+    }
+
+    @Test
+    fun equivalenceClasses() {
+        val from = LocalDateTime(2020, 1, 1, 0, 0).toInstant(TimeZone.UTC)
+        val until = LocalDateTime(2021, 1, 1, 0, 0).toInstant(TimeZone.UTC)
+        val berlin = TimeZone.of("Europe/Berlin")
+        val paris = TimeZone.of("Europe/Paris")
+        val lagos = TimeZone.of("Africa/Lagos")
+        assertEquals(listOf(listOf(lagos), listOf(berlin, paris)).map { it.toSet() }.toSet(),
+            TimeZone.equivalenceClasses(from, until, listOf(berlin, lagos, paris)).map { it.toSet() }.toSet())
+        val classes = TimeZone.equivalenceClasses(from, until)
+        assertEquals(1, classes.count { berlin in it && paris in it })
+        assertEquals(classes.sumOf { it.size }, classes.flatten().toSet().size)
+        for (zones in classes) {
+            var instant = from
+            while (instant < until) {
+                assertEquals(1, zones.map { instant.offsetIn(it) }.toSet().size)
+                instant = instant.plus(7, DateTimeUnit.DAY, TimeZone.UTC)
+            }
+        }
+        assertFailsWith<IllegalArgumentException> {
+            TimeZone.equivalenceClasses(from, until, listOf(TimeZone.of("+01:00")))
+        }
+    }
+
+    @Test
+    fun abbreviations() {
+        if (Platform.osFamily == OsFamily.WINDOWS) return // no abbreviations there
+        val berlin = TimeZone.of("Europe/Berlin")
+        val winter = LocalDateTime(2021, 1, 15, 12, 0).toInstant(berlin)
+        val summer = LocalDateTime(2021, 7, 15, 12, 0).toInstant(berlin)
+        assertEquals("CET", berlin.abbreviationAt(winter))
+        assertEquals("CEST", berlin.abbreviationAt(summer))
+        assertEquals("+01:00", TimeZone.of("+01:00").abbreviationAt(winter))
+        val zones = TimeZone.zonesWithAbbreviation("IST", winter, summer)
+        assertTrue(TimeZone.of("Asia/Kolkata") in zones)
+        assertTrue(TimeZone.of("Europe/Dublin") in zones)
+        assertFalse(berlin in zones)
+        assertTrue(TimeZone.zonesWithAbbreviation("CEST", winter, winter + Duration.days(1)).isEmpty())
+        assertTrue(berlin in TimeZone.zonesWithAbbreviation("CEST", winter, summer))
+    }
+
+    @Test
+    fun ofAll() {
+        val ids = listOf("Europe/Paris", "+03:00", "America/New_York", "UTC", "Europe/Paris", "Asia/Kolkata")
+        val zones = TimeZone.ofAll(ids)
+        assertEquals(ids, zones.map { it.id })
+        assertEquals(ids.map { TimeZone.of(it) }, zones)
+        assertTrue(zones[1] is FixedOffsetTimeZone)
+        assertTrue(zones[3] is FixedOffsetTimeZone)
+        assertSame(zones[0], zones[4])
+        assertSame(zones[0], TimeZone.of("Europe/Paris"))
+        assertFailsWith<IllegalTimeZoneException> { TimeZone.ofAll(listOf("Europe/Paris", "Mars/Olympus_Mons")) }
+        assertTrue(TimeZone.ofAll(emptyList()).isEmpty())
+    }
+
+    @Test
+    fun zonesWithIdPrefix() {
+        val newYork = TimeZone.of("America/New_York")
+        assertTrue(newYork in TimeZone.zonesWithIdPrefix("new_y"))
+        assertTrue(newYork in TimeZone.zonesWithIdPrefix("York"))
+        assertTrue(newYork in TimeZone.zonesWithIdPrefix("America/New"))
+        assertFalse(newYork in TimeZone.zonesWithIdPrefix("york", ignoreCase = false))
+        assertFalse(newYork in TimeZone.zonesWithIdPrefix("ork"))
+        val european = TimeZone.zonesWithIdPrefix("Europe/", ignoreCase = false)
+        assertTrue(european.isNotEmpty())
+        assertTrue(european.all { it.id.startsWith("Europe/") })
+        assertEquals(
+            TimeZone.availableZoneIds.filter { it.startsWith("Europe/") }.toSet(),
+            european.map { it.id }.toSet()
+        )
+        assertTrue(TimeZone.zonesWithIdPrefix("Mars/").isEmpty())
+    }
+}
@@ -0,0 +1,384 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime
+
+/**
+ * Parsing and formatting of the date-times used in HTTP headers and emails.
+ *
+ * The HTTP-date format is the one of RFC 1123 that RFC 7231 calls `IMF-fixdate`: `Sun, 06 Nov 1994 08:49:37 GMT`.
+ * All its fields have fixed widths, so a date-time is read from and written to fixed positions, and the functions that
+ * process many date-times at once don't allocate anything per date-time.
+ *
+ * The RFC 2822 format is a more lenient relative of it, allowing for other offsets and for omitting some fields:
+ * `Sun, 6 Nov 1994 10:49 +0200`.
+ */
+public object HttpDate {
+    /**
+     * The length of a date-time in the HTTP-date format.
+     */
+    public const val LENGTH: Int = 29
+
+    /**
+     * Parses a date-time in the HTTP-date format, like `Sun, 06 Nov 1994 08:49:37 GMT`.
+     *
+     * A leap second, `23:59:60`, is parsed as `23:59:59`.
+     *
+     * @throws DateTimeFormatException if [text] is not in the HTTP-date format or the day of the week is wrong.
+     */
+    public fun parse(text: String): Instant = Instant(parseFixdate(0, text.length) { text[it].code }, 0)
+
+    /**
+     * Formats [instant] in the HTTP-date format, like `Sun, 06 Nov 1994 08:49:37 GMT`, dropping the fraction of
+     * a second.
+     *
+     * @throws IllegalArgumentException if the year of [instant] in UTC is not in 0..9999.
+     */
+    public fun format(instant: Instant): String {
+        val chars = CharArray(LENGTH)
+        formatFixdate(instant.epochSeconds) { i, c -> chars[i] = c.toChar() }
+        return chars.concatToString()
+    }
+
+    /**
+     * Parses each of [texts] in the HTTP-date format and returns the numbers of seconds since the epoch.
+     *
+     * @throws DateTimeFormatException if some of [texts] is not in the HTTP-date format.
+     */
+    public fun parseEpochSeconds(texts: List<String>): LongArray = LongArray(texts.size) {
+        val text = texts[it]
+        parseFixdate(0, text.length) { i -> text[i].code }
+    }
+
+    /**
+     * Parses the ASCII date-times in the HTTP-date format that start in [bytes] at each of [starts] and returns
+     * the numbers of seconds since the epoch.
+     *
+     * This is meant for processing raw logs without creating strings.
+     *
+     * @throws DateTimeFormatException if some of the date-times is not in the HTTP-date format.
+     * @throws IndexOutOfBoundsException if some of the date-times doesn't fit into [bytes].
+     */
+    public fun parseEpochSeconds(bytes: ByteArray, starts: IntArray): LongArray = LongArray(starts.size) {
+        val start = starts[it]
+        if (start < 0 || start > bytes.size - LENGTH) {
+            throw IndexOutOfBoundsException("A date-time at $start doesn't fit into ${bytes.size} bytes")
+        }
+        parseFixdate(start, start + LENGTH) { i -> bytes[i].toInt() and 0xff }
+    }
+
+    /**
+     * Formats each of the numbers of seconds since the epoch in [epochSeconds] in the HTTP-date format as ASCII,
+     * writing them one after another into [destination], starting from [destinationOffset].
+     *
+     * @throws IllegalArgumentException if the year of some instant in UTC is not in 0..9999.
+     * @throws IndexOutOfBoundsException if [destination] can't fit all the date-times.
+     */
+    public fun formatEpochSeconds(epochSeconds: LongArray, destination: ByteArray, destinationOffset: Int = 0) {
+        if (destinationOffset < 0 || destinationOffset > destination.size - epochSeconds.size.toLong() * LENGTH) {
+            throw IndexOutOfBoundsException(
+                "${epochSeconds.size} date-times don't fit into ${destination.size} bytes from $destinationOffset")
+        }
+        var position = destinationOffset
+        for (seconds in epochSeconds) {
+            val start = position
+            formatFixdate(seconds) { i, c -> destination[start + i] = c.toByte() }
+            position += LENGTH
+        }
+    }
+
+    /**
+     * Parses a date-time in the format of RFC 2822, like `Sun, 6 Nov 1994 10:49:37 +0200`.
+     *
+     * The day of the week and the seconds are optional, and so is the whitespace around the `:` and `,` separators.
+     * Also accepted are the obsolete forms RFC 2822 allows reading: two- and three-digit years, comments in
+     * parentheses, and the named zones, like `GMT` or `EST`; single-letter military zones are treated as `-0000`,
+     * as RFC 2822 recommends.
+     *
+     * @throws DateTimeFormatException if [text] is not in the RFC 2822 format or the day of the week is wrong.
+     */
+    public fun parseRfc2822(text: String): Instant = Rfc2822Parser(text).parse()
+
+    /**
+     * Formats [instant] in the format of RFC 2822 with the given [offset], like `Sun, 06 Nov 1994 10:49:37 +0200`,
+     * dropping the fraction of a second and the seconds of the offset.
+     *
+     * @throws IllegalArgumentException if the year of [instant] at [offset] is not in 0..9999.
+     */
+    public fun formatRfc2822(instant: Instant, offset: UtcOffset = UtcOffset.ZERO): String {
+        val offsetMinutes = offset.totalSeconds / 60
+        val chars = CharArray(LENGTH + 2)
+        formatFixdate(instant.epochSeconds + offsetMinutes * 60) { i, c -> chars[i] = c.toChar() }
+        val magnitude = if (offsetMinutes < 0) -offsetMinutes else offsetMinutes
+        chars[26] = if (offsetMinutes < 0) '-' else '+'
+        chars[27] = '0' + magnitude / 600
+        chars[28] = '0' + magnitude / 60 % 10
+        chars[29] = '0' + magnitude % 60 / 10
+        chars[30] = '0' + magnitude % 10
+        return chars.concatToString()
+    }
+}
+
+private const val DAY_NAMES = "MonTueWedThuFriSatSun"
+private const val MONTH_NAMES = "JanFebMarAprMayJunJulAugSepOctNovDec"
+private const val MIN_HTTP_DATE_SECOND = -62167219200L // 0000-01-01T00:00:00Z
+private const val MAX_HTTP_DATE_SECOND = 253402300799L // 9999-12-31T23:59:59Z
+
+private fun httpDateException(message: String, position: Int) =
+    DateTimeFormatException("Parse error at char $position: $message")
+
+private inline fun digitAt(position: Int, charAt: (Int) -> Int): Int {
+    val digit = charAt(position) - '0'.code
+    if (digit < 0 || digit > 9) {
+        throw httpDateException("digit expected", position)
+    }
+    return digit
+}
+
+private inline fun expectAt(position: Int, expected: Char, charAt: (Int) -> Int) {
+    if (charAt(position) != expected.code) {
+        throw httpDateException("'$expected' expected", position)
+    }
+}
+
+// The index of the three-letter name at `position` in `names`, or -1.
+private inline fun nameAt(position: Int, names: String, charAt: (Int) -> Int): Int {
+    val c0 = charAt(position)
+    val c1 = charAt(position + 1)
+    val c2 = charAt(position + 2)
+    for (i in 0 until names.length / 3) {
+        if (names[3 * i].code == c0 && names[3 * i + 1].code == c1 && names[3 * i + 2].code == c2) {
+            return i
+        }
+    }
+    return -1
+}
+
+/* Combines the fields into the number of seconds since the epoch, checking them. `dayOfWeek` is 0 for Monday, or -1 if
+   it was not given. `position` is where the date starts, to report errors. */
+private fun httpDateSeconds(
+    year: Int, month: Int, day: Int, hour: Int, minute: Int, second: Int, offsetSeconds: Int, dayOfWeek: Int,
+    position: Int
+): Long {
+    if (day < 1 || day > month.monthLength(isLeapYear(year))) {
+        throw httpDateException("invalid day of month $day", position)
+    }
+    if (hour > 23 || minute > 59 || second > 60) {
+        throw httpDateException("invalid time $hour:$minute:$second", position)
+    }
+    val epochDay = epochDayOf(year, month, day).toLong()
+    if (dayOfWeek >= 0 && dayOfWeek != floorMod(epochDay + 3, 7L).toInt()) {
+        throw httpDateException("wrong day of week", position)
+    }
+    // A leap second is parsed as the second before it, like in ISO strings.
+    return epochDay * 86400 + hour * 3600 + minute * 60 + minOf(second, 59) - offsetSeconds
+}
+
+private inline fun parseFixdate(start: Int, end: Int, charAt: (Int) -> Int): Long {
+    if (end - start != HttpDate.LENGTH) {
+        throw httpDateException("expected ${HttpDate.LENGTH} characters, got ${end - start}", start)
+    }
+    val dayOfWeek = nameAt(start, DAY_NAMES, charAt)
+    if (dayOfWeek < 0) {
+        throw httpDateException("day of week expected", start)
+    }
+    expectAt(start + 3, ',', charAt)
+    expectAt(start + 4, ' ', charAt)
+    val day = digitAt(start + 5, charAt) * 10 + digitAt(start + 6, charAt)
+    expectAt(start + 7, ' ', charAt)
+    val month = nameAt(start + 8, MONTH_NAMES, charAt) + 1
+    if (month == 0) {
+        throw httpDateException("month expected", start + 8)
+    }
+    expectAt(start + 11, ' ', charAt)
+    val year = digitAt(start + 12, charAt) * 1000 + digitAt(start + 13, charAt) * 100 +
+        digitAt(start + 14, charAt) * 10 + digitAt(start + 15, charAt)
+    expectAt(start + 16, ' ', charAt)
+    val hour = digitAt(start + 17, charAt) * 10 + digitAt(start + 18, charAt)
+    expectAt(start + 19, ':', charAt)
+    val minute = digitAt(start + 20, charAt) * 10 + digitAt(start + 21, charAt)
+    expectAt(start + 22, ':', charAt)
+    val second = digitAt(start + 23, charAt) * 10 + digitAt(start + 24, charAt)
+    expectAt(start + 25, ' ', charAt)
+    expectAt(start + 26, 'G', charAt)
+    expectAt(start + 27, 'M', charAt)
+    expectAt(start + 28, 'T', charAt)
+    return httpDateSeconds(year, month, day, hour, minute, second, 0, dayOfWeek, start + 5)
+}
+
+private inline fun formatFixdate(epochSeconds: Long, put: (Int, Int) -> Unit) {
+    require(epochSeconds in MIN_HTTP_DATE_SECOND..MAX_HTTP_DATE_SECOND) {
+        "The instant at $epochSeconds seconds since the epoch can't be represented in the HTTP-date format"
+    }
+    val epochDay = floorDiv(epochSeconds, 86400L)
+    val secondOfDay = (epochSeconds - epochDay * 86400).toInt()
+    val dayOfWeek = floorMod(epochDay + 3, 7L).toInt()
+    put(0, DAY_NAMES[3 * dayOfWeek].code)
+    put(1, DAY_NAMES[3 * dayOfWeek + 1].code)
+    put(2, DAY_NAMES[3 * dayOfWeek + 2].code)
+    put(3, ','.code)
+    put(4, ' '.code)
+    withDateOfEpochDay(epochDay.toInt()) { year, month, day ->
+        put(5, '0'.code + day / 10)
+        put(6, '0'.code + day % 10)
+        put(7, ' '.code)
+        put(8, MONTH_NAMES[3 * month - 3].code)
+        put(9, MONTH_NAMES[3 * month - 2].code)
+        put(10, MONTH_NAMES[3 * month - 1].code)
+        put(11, ' '.code)
+        put(12, '0'.code + year / 1000)
+        put(13, '0'.code + year / 100 % 10)
+        put(14, '0'.code + year / 10 % 10)
+        put(15, '0'.code + year % 10)
+    }
+    put(16, ' '.code)
+    val hour = secondOfDay / 3600
+    val minute = secondOfDay / 60 % 60
+    val second = secondOfDay % 60
+    put(17, '0'.code + hour / 10)
+    put(18, '0'.code + hour % 10)
+    put(19, ':'.code)
+    put(20, '0'.code + minute / 10)
+    put(21, '0'.code + minute % 10)
+    put(22, ':'.code)
+    put(23, '0'.code + second / 10)
+    put(24, '0'.code + second % 10)
+    put(25, ' '.code)
+    put(26, 'G'.code)
+    put(27, 'M'.code)
+    put(28, 'T'.code)
+}
+
+// The obsolete zone names of RFC 2822 and their offsets in hours.
+@SharedImmutable
+private val namedZones = mapOf(
+    "UT" to 0, "GMT" to 0, "EST" to -5, "EDT" to -4, "CST" to -6, "CDT" to -5, "MST" to -7, "MDT" to -6,
+    "PST" to -8, "PDT" to -7
+)
+
+private class Rfc2822Parser(private val text: String) {
+    private var position = 0
+
+    fun parse(): Instant {
+        skipWhitespace()
+        var dayOfWeek = -1
+        if (position < text.length && text[position].isLetter()) {
+            dayOfWeek = name(DAY_NAMES, "day of week")
+            skipWhitespace()
+            expect(',')
+            skipWhitespace()
+        }
+        val dayPosition = position
+        val day = number(1, 2)
+        skipWhitespace()
+        val month = name(MONTH_NAMES, "month") + 1
+        skipWhitespace()
+        val yearStart = position
+        var year = number(2, 4)
+        when (position - yearStart) {
+            2 -> year += if (year < 50) 2000 else 1900
+            3 -> year += 1900
+        }
+        skipWhitespace()
+        val hour = number(2, 2)
+        skipWhitespace()
+        expect(':')
+        skipWhitespace()
+        val minute = number(2, 2)
+        skipWhitespace()
+        var second = 0
+        if (position < text.length && text[position] == ':') {
+            ++position
+            skipWhitespace()
+            second = number(2, 2)
+            skipWhitespace()
+        }
+        val offsetSeconds = zone()
+        skipWhitespace()
+        if (position != text.length) {
+            throw httpDateException("extraneous input", position)
+        }
+        return Instant(
+            httpDateSeconds(year, month, day, hour, minute, second, offsetSeconds, dayOfWeek, dayPosition), 0)
+    }
+
+    private fun zone(): Int {
+        if (position < text.length && (text[position] == '+' || text[position] == '-')) {
+            val sign = if (text[position] == '-') -1 else 1
+            ++position
+            val hours = number(2, 2)
+            val minutes = number(2, 2)
+            if (minutes > 59) {
+                throw httpDateException("invalid offset minutes $minutes", position - 2)
+            }
+            return sign * (hours * 3600 + minutes * 60)
+        }
+        val start = position
+        while (position < text.length && text[position].isLetter()) {
+            ++position
+        }
+        // The names are case-insensitive.
+        val name = buildString {
+            for (i in start until position) {
+                val c = text[i]
+                append(if (c in 'a'..'z') c - ('a' - 'A') else c)
+            }
+        }
+        return when {
+            name.length == 1 && name != "J" -> 0 // military zones are unreliable, so the offset is unknown
+            else -> (namedZones[name] ?: throw httpDateException("zone expected", start)) * 3600
+        }
+    }
+
+    /* Skips whitespace, including folding, and comments, which can be nested. */
+    private fun skipWhitespace() {
+        var depth = 0
+        while (position < text.length) {
+            val c = text[position]
+            when {
+                c == '(' -> ++depth
+                c == ')' && depth > 0 -> --depth
+                c == '\\' && depth > 0 -> ++position
+                depth == 0 && c != ' ' && c != '\t' && c != '\r' && c != '\n' -> return
+            }
+            ++position
+        }
+        if (depth > 0) {
+            throw httpDateException("unterminated comment", position)
+        }
+    }
+
+    private fun expect(c: Char) {
+        if (position >= text.length || text[position] != c) {
+            throw httpDateException("'$c' expected", position)
+        }
+        ++position
+    }
+
+    private fun number(minDigits: Int, maxDigits: Int): Int {
+        val start = position
+        var result = 0
+        while (position < text.length && position - start < maxDigits && text[position] in '0'..'9') {
+            result = result * 10 + (text[position] - '0')
+            ++position
+        }
+        if (position - start < minDigits) {
+            throw httpDateException("expected at least $minDigits digits", start)
+        }
+        return result
+    }
+
+    private fun name(names: String, what: String): Int {
+        if (position + 3 > text.length) {
+            throw httpDateException("$what expected", position)
+        }
+        val index = nameAt(position, names) { text[it].code }
+        if (index < 0) {
+            throw httpDateException("$what expected", position)
+        }
+        position += 3
+        return index
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime
+
+/**
+ * The ISO 8601 week dates, like `2020-W53-5` for 2021-01-01, and the ordinal dates, the years and the numbers of the days
+ * in them.
+ *
+ * A week-based year consists of whole weeks starting on Monday, and its first week is the one with the first Thursday
+ * of the calendar year, so the week-based year of a date near January 1 may differ from its calendar year.
+ *
+ * Besides the functions for a single date, there are ones that fill the columns of these fields for many dates given
+ * as the numbers of days since 1970-01-01, using the same calendar math as the conversion of such numbers to
+ * [LocalDate], but without creating a [LocalDate] for each of them.
+ */
+public object IsoWeekDate {
+    /**
+     * Returns the week-based year of [date].
+     */
+    public fun weekBasedYear(date: LocalDate): Int = weekBasedYearOf(date.toEpochDay())
+
+    /**
+     * Returns the number of the week of [date] in its week-based year, from 1 to 53.
+     */
+    public fun weekOfWeekBasedYear(date: LocalDate): Int = weekOf(date.toEpochDay())
+
+    /**
+     * Returns the number of weeks in the week-based [year], 52 or 53.
+     */
+    public fun weeksInWeekBasedYear(year: Int): Int = weekOf(LocalDate(year, 12, 28).toEpochDay())
+
+    /**
+     * Formats [date] as an ISO 8601 week date, like `2020-W53-5`.
+     *
+     * The week-based year is written with at least four digits and with a sign if it has more, like the year in
+     * [LocalDate.toString].
+     */
+    public fun format(date: LocalDate): String {
+        val epochDay = date.toEpochDay()
+        val week = weekOf(epochDay)
+        return StringBuilder(10).appendIsoYear(weekBasedYearOf(epochDay))
+            .append(if (week < 10) "-W0" else "-W")
+            .append(week)
+            .append('-')
+            .append(dayOfWeekOf(epochDay))
+            .toString()
+    }
+
+    /**
+     * Parses an ISO 8601 week date, like `2020-W53-5`.
+     *
+     * @throws DateTimeFormatException if [text] is not an ISO 8601 week date, the week doesn't exist in its
+     * week-based year, or the date exceeds the boundaries of [LocalDate].
+     */
+    public fun parse(text: String): LocalDate = isoWeekDateParser.parse(text)
+
+    /**
+     * Returns the date that is the given [dayOfWeek] of the given [week] of the week-based [year].
+     *
+     * @throws IllegalArgumentException if the week doesn't exist in the year or the date exceeds the boundaries of
+     * [LocalDate].
+     */
+    public fun of(year: Int, week: Int, dayOfWeek: DayOfWeek): LocalDate {
+        require(week >= 1 && week <= weeksInWeekBasedYear(year)) {
+            "Invalid week date: the week-based year $year has no week $week"
+        }
+        // January 4 is always in the first week.
+        val january4 = LocalDate(year, 1, 4).toEpochDay()
+        val monday = january4 - dayOfWeekOf(january4) + 1
+        return LocalDate.ofEpochDay(monday + (week - 1) * 7 + dayOfWeek.isoDayNumber - 1)
+    }
+
+    /**
+     * Fills the week dates of the days since 1970-01-01 in [epochDays]: for each index `i`, [weekBasedYears]`[i]`,
+     * [weeks]`[i]` and [daysOfWeek]`[i]` become the week-based year, the week and the ISO number of the day of the
+     * week, from 1 for Monday to 7 for Sunday, of `epochDays[i]`.
+     *
+     * @throws IllegalArgumentException if some of the days exceeds the boundaries of [LocalDate] or the
+     * destination arrays are smaller than [epochDays].
+     */
+    public fun fillWeekDates(epochDays: IntArray, weekBasedYears: IntArray, weeks: IntArray, daysOfWeek: IntArray) {
+        require(weekBasedYears.size >= epochDays.size && weeks.size >= epochDays.size &&
+            daysOfWeek.size >= epochDays.size) { "The destination arrays are smaller than the source one" }
+        for (i in epochDays.indices) {
+            val epochDay = checkedEpochDay(epochDays[i])
+            val dayOfWeek = dayOfWeekOf(epochDay)
+            // The week-based year of a day is the calendar year of the Thursday of its week.
+            withMarchBasedDay(epochDay - dayOfWeek + 4) { marchYear, marchDoy0 ->
+                weekBasedYears[i] = if (marchDoy0 >= DAYS_MARCH_TO_JANUARY) marchYear + 1 else marchYear
+                weeks[i] = dayOfYear0(marchYear, marchDoy0) / 7 + 1
+            }
+            daysOfWeek[i] = dayOfWeek
+        }
+    }
+
+    /**
+     * Fills the ordinal dates of the days since 1970-01-01 in [epochDays]: for each index `i`, [years]`[i]` and
+     * [daysOfYear]`[i]` become the calendar year of `epochDays[i]` and the number of the day in that year, from 1.
+     *
+     * @throws IllegalArgumentException if some of the days exceeds the boundaries of [LocalDate] or the
+     * destination arrays are smaller than [epochDays].
+     */
+    public fun fillOrdinalDates(epochDays: IntArray, years: IntArray, daysOfYear: IntArray) {
+        require(years.size >= epochDays.size && daysOfYear.size >= epochDays.size) {
+            "The destination arrays are smaller than the source one"
+        }
+        for (i in epochDays.indices) {
+            withMarchBasedDay(checkedEpochDay(epochDays[i])) { marchYear, marchDoy0 ->
+                years[i] = if (marchDoy0 >= DAYS_MARCH_TO_JANUARY) marchYear + 1 else marchYear
+                daysOfYear[i] = dayOfYear0(marchYear, marchDoy0) + 1
+            }
+        }
+    }
+}
+
+// The number of days from March 1 to January 1 of the next year.
+private const val DAYS_MARCH_TO_JANUARY = 306
+
+// The zero-based day in the calendar year of a day given as in `withMarchBasedDay`.
+private fun dayOfYear0(marchYear: Int, marchDoy0: Int): Int =
+    if (marchDoy0 >= DAYS_MARCH_TO_JANUARY) {
+        marchDoy0 - DAYS_MARCH_TO_JANUARY
+    } else {
+        marchDoy0 + if (isLeapYear(marchYear)) 60 else 59
+    }
+
+private fun checkedEpochDay(epochDay: Int): Int {
+    require(epochDay >= LocalDate.MIN_EPOCH_DAY && epochDay <= LocalDate.MAX_EPOCH_DAY) {
+        "Invalid date: boundaries of LocalDate exceeded"
+    }
+    return epochDay
+}
+
+private fun dayOfWeekOf(epochDay: Int): Int = floorMod(epochDay + 3, 7) + 1
+
+private fun weekBasedYearOf(epochDay: Int): Int =
+    withMarchBasedDay(epochDay - dayOfWeekOf(epochDay) + 4) { marchYear, marchDoy0 ->
+        if (marchDoy0 >= DAYS_MARCH_TO_JANUARY) marchYear + 1 else marchYear
+    }
+
+private fun weekOf(epochDay: Int): Int =
+    withMarchBasedDay(epochDay - dayOfWeekOf(epochDay) + 4) { marchYear, marchDoy0 ->
+        dayOfYear0(marchYear, marchDoy0) / 7 + 1
+    }
+
+private val isoWeekDateParser: Parser<LocalDate>
+    get() = intParser(4, 10, SignStyle.EXCEEDS_PAD)
+        .chainIgnoring(concreteCharParser('-'))
+        .chainIgnoring(concreteCharParser('W'))
+        .chain(intParser(2, 2))
+        .chainIgnoring(concreteCharParser('-'))
+        .chain(intParser(1, 1))
+        .map {
+            val (yearWeek, day) = it
+            val (year, week) = yearWeek
+            try {
+                IsoWeekDate.of(year, week, DayOfWeek(day))
+            } catch (e: IllegalArgumentException) {
+                throw DateTimeFormatException(e)
+            }
+        }
@@ -69,33 +69,7 @@ public actual class LocalDate actual constructor(public actual val year: Int, pu
             require(epochDay >= MIN_EPOCH_DAY && epochDay <= MAX_EPOCH_DAY) {
                 "Invalid date: boundaries of LocalDate exceeded"
             }
-            var zeroDay = epochDay + DAYS_0000_TO_1970
-            // find the march-based year
-            zeroDay -= 60 // adjust to 0000-03-01 so leap day is at end of four year cycle
-
-            var adjust = 0
-            if (zeroDay < 0) { // adjust negative years to positive for calculation
-                val adjustCycles = (zeroDay + 1) / DAYS_PER_CYCLE - 1
-                adjust = adjustCycles * 400
-                zeroDay += -adjustCycles * DAYS_PER_CYCLE
-            }
-            var yearEst = ((400 * zeroDay.toLong() + 591) / DAYS_PER_CYCLE).toInt()
-            var doyEst = zeroDay - (365 * yearEst + yearEst / 4 - yearEst / 100 + yearEst / 400)
-            if (doyEst < 0) { // fix estimate
-                yearEst--
-                doyEst = zeroDay - (365 * yearEst + yearEst / 4 - yearEst / 100 + yearEst / 400)
-            }
-            yearEst += adjust // reset any negative year
-
-            val marchDoy0 = doyEst
-
-            // convert march-based values back to january-based
-            val marchMonth0 = (marchDoy0 * 5 + 2) / 153
-            val month = (marchMonth0 + 2) % 12 + 1
-            val dom = marchDoy0 - (marchMonth0 * 306 + 5) / 10 + 1
-            yearEst += marchMonth0 / 10
-
-            return LocalDate(yearEst, month, dom)
+            return withDateOfEpochDay(epochDay) { year, month, dom -> LocalDate(year, month, dom) }
         }
 
         internal actual val MIN = LocalDate(YEAR_MIN, 1, 1)
@@ -105,27 +79,7 @@ public actual class LocalDate actual constructor(public actual val year: Int, pu
         internal const val MAX_EPOCH_DAY = 364522971
     }
 
-    // org.threeten.bp.LocalDate#toEpochDay
-    internal fun toEpochDay(): Int {
-        val y = year
-        val m = monthNumber
-        var total = 0
-        total += 365 * y
-        if (y >= 0) {
-            total += (y + 3) / 4 - (y + 99) / 100 + (y + 399) / 400
-        } else {
-            total -= y / -4 - y / -100 + y / -400
-        }
-        total += ((367 * m - 362) / 12)
-        total += dayOfMonth - 1
-        if (m > 2) {
-            total--
-            if (!isLeapYear(year)) {
-                total--
-            }
-        }
-        return total - DAYS_0000_TO_1970
-    }
+    internal fun toEpochDay(): Int = epochDayOf(year, monthNumber, dayOfMonth)
 
     // org.threeten.bp.LocalDate#withYear
     /**
@@ -228,21 +182,9 @@ public actual class LocalDate actual constructor(public actual val year: Int, pu
         val yearValue = year
         val monthValue: Int = monthNumber
         val dayValue: Int = dayOfMonth
-        val absYear: Int = abs(yearValue)
         val buf = StringBuilder(10)
-        if (absYear < 1000) {
-            if (yearValue < 0) {
-                buf.append(yearValue - 10000).deleteAt(1)
-            } else {
-                buf.append(yearValue + 10000).deleteAt(0)
-            }
-        } else {
-            if (yearValue > 9999) {
-                buf.append('+')
-            }
-            buf.append(yearValue)
-        }
-        return buf.append(if (monthValue < 10) "-0" else "-")
+        return buf.appendIsoYear(yearValue)
+            .append(if (monthValue < 10) "-0" else "-")
             .append(monthValue)
             .append(if (dayValue < 10) "-0" else "-")
             .append(dayValue)
@@ -312,3 +254,91 @@ public actual fun LocalDate.periodUntil(other: LocalDate): DatePeriod {
     val days = plusMonths(months).daysUntil(other)
     return DatePeriod(totalMonths = months, days)
 }
+
+/**
+ * Finds the year of [epochDay] that starts on March 1, so that the leap day is at its end, and the zero-based number
+ * of the day in that year, and passes them to [block].
+ *
+ * This is the calendar math of [LocalDate.ofEpochDay], shared with the functions that only need some of the fields.
+ * [epochDay] is expected to be within the boundaries of [LocalDate], give or take a few days.
+ */
+/**
+ * Returns the number of days since 1970-01-01 of a valid date in the ISO calendar, without creating a [LocalDate].
+ */
+internal fun epochDayOf(year: Int, monthNumber: Int, dayOfMonth: Int): Int {
+    // org.threeten.bp.LocalDate#toEpochDay
+    val y = year
+    val m = monthNumber
+    var total = 0
+    total += 365 * y
+    if (y >= 0) {
+        total += (y + 3) / 4 - (y + 99) / 100 + (y + 399) / 400
+    } else {
+        total -= y / -4 - y / -100 + y / -400
+    }
+    total += ((367 * m - 362) / 12)
+    total += dayOfMonth - 1
+    if (m > 2) {
+        total--
+        if (!isLeapYear(year)) {
+            total--
+        }
+    }
+    return total - DAYS_0000_TO_1970
+}
+
+/**
+ * Calls [block] with the year, the month number, and the day of month of the date that is [epochDay] days after
+ * 1970-01-01, without creating a [LocalDate]. The day is not checked to be within the boundaries of [LocalDate].
+ */
+internal inline fun <T> withDateOfEpochDay(
+    epochDay: Int,
+    block: (year: Int, monthNumber: Int, dayOfMonth: Int) -> T
+): T = withMarchBasedDay(epochDay) { marchYear, marchDoy0 ->
+    // convert march-based values back to january-based
+    val marchMonth0 = (marchDoy0 * 5 + 2) / 153
+    val month = (marchMonth0 + 2) % 12 + 1
+    val dom = marchDoy0 - (marchMonth0 * 306 + 5) / 10 + 1
+    block(marchYear + marchMonth0 / 10, month, dom)
+}
+
+internal inline fun <T> withMarchBasedDay(epochDay: Int, block: (marchYear: Int, marchDoy0: Int) -> T): T {
+    // org.threeten.bp.LocalDate#ofEpochDay
+    var zeroDay = epochDay + DAYS_0000_TO_1970
+    // find the march-based year
+    zeroDay -= 60 // adjust to 0000-03-01 so leap day is at end of four year cycle
+
+    var adjust = 0
+    if (zeroDay < 0) { // adjust negative years to positive for calculation
+        val adjustCycles = (zeroDay + 1) / DAYS_PER_CYCLE - 1
+        adjust = adjustCycles * 400
+        zeroDay += -adjustCycles * DAYS_PER_CYCLE
+    }
+    var yearEst = ((400 * zeroDay.toLong() + 591) / DAYS_PER_CYCLE).toInt()
+    var doyEst = zeroDay - (365 * yearEst + yearEst / 4 - yearEst / 100 + yearEst / 400)
+    if (doyEst < 0) { // fix estimate
+        yearEst--
+        doyEst = zeroDay - (365 * yearEst + yearEst / 4 - yearEst / 100 + yearEst / 400)
+    }
+    yearEst += adjust // reset any negative year
+    return block(yearEst, doyEst)
+}
+
+/**
+ * Appends [year] the way ISO 8601 writes it: with at least four digits and with a sign if it has more.
+ */
+internal fun StringBuilder.appendIsoYear(year: Int): StringBuilder {
+    if (abs(year) < 1000) {
+        if (year < 0) {
+            append(year - 10000).deleteAt(length - 5)
+        } else {
+            append(year + 10000).deleteAt(length - 5)
+        }
+    } else {
+        if (year > 9999) {
+            append('+')
+        }
+        append(year)
+    }
+    return this
+}
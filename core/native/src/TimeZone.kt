@@ -23,43 +23,9 @@ public actual open class TimeZone internal constructor() {
         public actual val UTC: FixedOffsetTimeZone = UtcOffset.ZERO.asTimeZone()
 
         // org.threeten.bp.ZoneId#of(java.lang.String)
-        public actual fun of(zoneId: String): TimeZone {
-            // TODO: normalize aliases?
-            if (zoneId == "Z") {
-                return UTC
-            }
-            if (zoneId.length == 1) {
-                throw IllegalTimeZoneException("Invalid zone ID: $zoneId")
-            }
-            try {
-                if (zoneId.startsWith("+") || zoneId.startsWith("-")) {
-                    return UtcOffset.parse(zoneId).asTimeZone()
-                }
-                if (zoneId == "UTC" || zoneId == "GMT" || zoneId == "UT") {
-                    return FixedOffsetTimeZone(UtcOffset.ZERO, zoneId)
-                }
-                if (zoneId.startsWith("UTC+") || zoneId.startsWith("GMT+") ||
-                    zoneId.startsWith("UTC-") || zoneId.startsWith("GMT-")
-                ) {
-                    val prefix = zoneId.take(3)
-                    val offset = UtcOffset.parse(zoneId.substring(3))
-                    return when (offset.totalSeconds) {
-                        0 -> FixedOffsetTimeZone(offset, prefix)
-                        else -> FixedOffsetTimeZone(offset, "$prefix$offset")
-                    }
-                }
-                if (zoneId.startsWith("UT+") || zoneId.startsWith("UT-")) {
-                    val offset = UtcOffset.parse(zoneId.substring(2))
-                    return when (offset.totalSeconds) {
-                        0 -> FixedOffsetTimeZone(offset, "UT")
-                        else -> FixedOffsetTimeZone(offset, "UT$offset")
-                    }
-                }
-            } catch (e: DateTimeFormatException) {
-                throw IllegalTimeZoneException(e)
-            }
-            return RegionTimeZone.of(zoneId)
-        }
+        // TODO: normalize aliases?
+        public actual fun of(zoneId: String): TimeZone =
+            fixedOffsetTimeZoneOrNull(zoneId) ?: RegionTimeZone.of(zoneId)
 
         public actual val availableZoneIds: Set<String>
             get() = RegionTimeZone.availableZoneIds
@@ -86,8 +52,12 @@ public actual open class TimeZone internal constructor() {
     internal open fun atZone(dateTime: LocalDateTime, preferred: UtcOffset? = null): ZonedDateTime =
         error("Should be overridden")
 
+    // The version of the time zone database the rules come from if it's not the one the system provides, so that the
+    // time zones with the same id from different versions are not equal.
+    internal open val rulesVersion: Any? get() = null
+
     override fun equals(other: Any?): Boolean =
-        this === other || other is TimeZone && this.id == other.id
+        this === other || other is TimeZone && this.id == other.id && this.rulesVersion == other.rulesVersion
 
     override fun hashCode(): Int = id.hashCode()
 
@@ -158,3 +128,44 @@ public actual fun LocalDateTime.toInstant(offset: UtcOffset): Instant =
 
 public actual fun LocalDate.atStartOfDayIn(timeZone: TimeZone): Instant =
     timeZone.atStartOfDay(this)
+
+/**
+ * Parses the ids of the time zones that are not region-based, or returns `null` if [zoneId] has to be looked up
+ * as a region.
+ */
+internal fun fixedOffsetTimeZoneOrNull(zoneId: String): TimeZone? {
+    if (zoneId == "Z") {
+        return TimeZone.UTC
+    }
+    if (zoneId.length == 1) {
+        throw IllegalTimeZoneException("Invalid zone ID: $zoneId")
+    }
+    try {
+        if (zoneId.startsWith("+") || zoneId.startsWith("-")) {
+            return UtcOffset.parse(zoneId).asTimeZone()
+        }
+        if (zoneId == "UTC" || zoneId == "GMT" || zoneId == "UT") {
+            return FixedOffsetTimeZone(UtcOffset.ZERO, zoneId)
+        }
+        if (zoneId.startsWith("UTC+") || zoneId.startsWith("GMT+") ||
+            zoneId.startsWith("UTC-") || zoneId.startsWith("GMT-")
+        ) {
+            val prefix = zoneId.take(3)
+            val offset = UtcOffset.parse(zoneId.substring(3))
+            return when (offset.totalSeconds) {
+                0 -> FixedOffsetTimeZone(offset, prefix)
+                else -> FixedOffsetTimeZone(offset, "$prefix$offset")
+            }
+        }
+        if (zoneId.startsWith("UT+") || zoneId.startsWith("UT-")) {
+            val offset = UtcOffset.parse(zoneId.substring(2))
+            return when (offset.totalSeconds) {
+                0 -> FixedOffsetTimeZone(offset, "UT")
+                else -> FixedOffsetTimeZone(offset, "UT$offset")
+            }
+        }
+    } catch (e: DateTimeFormatException) {
+        throw IllegalTimeZoneException(e)
+    }
+    return null
+}
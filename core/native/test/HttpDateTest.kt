@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+import kotlin.time.*
+
+@OptIn(ExperimentalTime::class)
+class HttpDateTest {
+    private val example = Instant.parse("1994-11-06T08:49:37Z")
+
+    @Test
+    fun parseAndFormat() {
+        assertEquals(example, HttpDate.parse("Sun, 06 Nov 1994 08:49:37 GMT"))
+        assertEquals("Sun, 06 Nov 1994 08:49:37 GMT", HttpDate.format(example))
+        assertEquals("Thu, 01 Jan 1970 00:00:00 GMT", HttpDate.format(Instant.fromEpochSeconds(0, 999_999_999)))
+        assertEquals("Tue, 29 Feb 2000 23:59:59 GMT", HttpDate.format(Instant.parse("2000-02-29T23:59:59Z")))
+        assertEquals("Fri, 31 Dec 9999 23:59:59 GMT", HttpDate.format(Instant.parse("9999-12-31T23:59:59Z")))
+        assertEquals(Instant.parse("2016-12-31T23:59:59Z"), HttpDate.parse("Sat, 31 Dec 2016 23:59:60 GMT"))
+        for (seconds in listOf(-62167219200L, -1L, 951782400L, 1234567890L, 253402300799L)) {
+            val instant = Instant.fromEpochSeconds(seconds)
+            assertEquals(instant, HttpDate.parse(HttpDate.format(instant)))
+        }
+        assertFailsWith<IllegalArgumentException> { HttpDate.format(Instant.parse("+10000-01-01T00:00:00Z")) }
+    }
+
+    @Test
+    fun invalid() {
+        for (text in listOf(
+            "Mon, 06 Nov 1994 08:49:37 GMT", // wrong day of the week
+            "Sun, 06 Nov 1994 08:49:37 UTC",
+            "Sun, 6 Nov 1994 08:49:37 GMT",
+            "Sun, 31 Nov 1994 08:49:37 GMT",
+            "Sun, 06 Nov 1994 24:00:00 GMT",
+            "Sun, 06 Nox 1994 08:49:37 GMT",
+            "Sunday, 06-Nov-94 08:49:37 GMT",
+            "Sun, 06 Nov 1994 08:49:37 GMT ",
+        )) {
+            assertFailsWith<DateTimeFormatException>(text) { HttpDate.parse(text) }
+        }
+    }
+
+    @Test
+    fun bulk() {
+        val seconds = longArrayOf(784111777, 0, 1622505600, -86400)
+        val bytes = ByteArray(seconds.size * HttpDate.LENGTH + 2)
+        HttpDate.formatEpochSeconds(seconds, bytes, 1)
+        val starts = IntArray(seconds.size) { 1 + it * HttpDate.LENGTH }
+        assertContentEquals(seconds, HttpDate.parseEpochSeconds(bytes, starts))
+        assertContentEquals(seconds, HttpDate.parseEpochSeconds(seconds.map { HttpDate.format(Instant.fromEpochSeconds(it)) }))
+        assertEquals("Sun, 06 Nov 1994 08:49:37 GMT", bytes.copyOfRange(1, 1 + HttpDate.LENGTH).decodeToString())
+        assertFailsWith<IndexOutOfBoundsException> { HttpDate.parseEpochSeconds(bytes, intArrayOf(bytes.size - 1)) }
+        assertFailsWith<IndexOutOfBoundsException> { HttpDate.formatEpochSeconds(seconds, bytes, 3) }
+    }
+
+    @Test
+    fun rfc2822() {
+        assertEquals(example, HttpDate.parseRfc2822("Sun, 06 Nov 1994 08:49:37 GMT"))
+        assertEquals(example, HttpDate.parseRfc2822("Sun, 6 Nov 1994 10:49:37 +0200"))
+        assertEquals(example, HttpDate.parseRfc2822("6 Nov 94 03:49:37 EST"))
+        assertEquals(example - Duration.seconds(37), HttpDate.parseRfc2822("  Sun , 6 Nov 1994 08 : 49 (comment (nested)) +0000"))
+        assertEquals(example, HttpDate.parseRfc2822("Sun, 06 Nov 1994 08:49:37 z"))
+        assertEquals("Sun, 06 Nov 1994 10:49:37 +0200", HttpDate.formatRfc2822(example, UtcOffset(hours = 2)))
+        assertEquals("Sun, 06 Nov 1994 05:19:37 -0330", HttpDate.formatRfc2822(example, UtcOffset(hours = -3, minutes = -30)))
+        for (text in listOf("Mon, 06 Nov 1994 08:49:37 GMT", "06 Nov 1994 08:49:37", "06 Nov 1994 08:49:37 +02", "06 Nov 1994 08:49:37 XYZ")) {
+            assertFailsWith<DateTimeFormatException>(text) { HttpDate.parseRfc2822(text) }
+        }
+    }
+}
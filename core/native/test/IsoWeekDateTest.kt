@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019-2020 JetBrains s.r.o.
+ * Use of this source code is governed by the Apache 2.0 License that can be found in the LICENSE.txt file.
+ */
+
+package kotlinx.datetime.test
+
+import kotlinx.datetime.*
+import kotlin.test.*
+
+class IsoWeekDateTest {
+    @Test
+    fun parseAndFormat() {
+        val examples = listOf(
+            LocalDate(2005, 1, 1) to "2004-W53-6",
+            LocalDate(2007, 12, 31) to "2008-W01-1",
+            LocalDate(2008, 12, 28) to "2008-W52-7",
+            LocalDate(2009, 12, 31) to "2009-W53-4",
+            LocalDate(2010, 1, 3) to "2009-W53-7",
+            LocalDate(2021, 1, 1) to "2020-W53-5",
+            LocalDate(1970, 1, 1) to "1970-W01-4",
+            LocalDate(-1, 12, 31) to "-0001-W52-5",
+            LocalDate(12345, 6, 7) to "+12345-W23-4",
+        )
+        for ((date, text) in examples) {
+            assertEquals(text, IsoWeekDate.format(date))
+            assertEquals(date, IsoWeekDate.parse(text))
+        }
+        assertEquals(53, IsoWeekDate.weeksInWeekBasedYear(2020))
+        assertEquals(52, IsoWeekDate.weeksInWeekBasedYear(2021))
+        for (text in listOf("2021-W53-1", "2021-W00-1", "2021-W01-0", "2021-W01-8", "2021-W1-1", "2021W011", "2021-01-01")) {
+            assertFailsWith<IllegalArgumentException>(text) { IsoWeekDate.parse(text) }
+        }
+    }
+
+    @Test
+    fun columns() {
+        val start = LocalDate(1999, 12, 20)
+        val epochDays = IntArray(1000) { start.plus(it, DateTimeUnit.DAY).toEpochDay() }
+        val weekBasedYears = IntArray(epochDays.size)
+        val weeks = IntArray(epochDays.size)
+        val daysOfWeek = IntArray(epochDays.size)
+        val years = IntArray(epochDays.size)
+        val daysOfYear = IntArray(epochDays.size)
+        IsoWeekDate.fillWeekDates(epochDays, weekBasedYears, weeks, daysOfWeek)
+        IsoWeekDate.fillOrdinalDates(epochDays, years, daysOfYear)
+        for (i in epochDays.indices) {
+            val date = start.plus(i, DateTimeUnit.DAY)
+            assertEquals(IsoWeekDate.weekBasedYear(date), weekBasedYears[i])
+            assertEquals(IsoWeekDate.weekOfWeekBasedYear(date), weeks[i])
+            assertEquals(date.dayOfWeek.isoDayNumber, daysOfWeek[i])
+            assertEquals(date.year, years[i])
+            assertEquals(date.dayOfYear, daysOfYear[i])
+            assertEquals(date, IsoWeekDate.parse(IsoWeekDate.format(date)))
+        }
+        assertFailsWith<IllegalArgumentException> {
+            IsoWeekDate.fillOrdinalDates(intArrayOf(Int.MAX_VALUE), IntArray(1), IntArray(1))
+        }
+    }
+}